@@ -1,2 +1,5 @@
 glslc src/shader/simple_shader.vert -o bin/shader/simple_shader.vert.spv
-glslc src/shader/simple_shader.frag -o bin/shader/simple_shader.frag.spv
\ No newline at end of file
+glslc src/shader/simple_shader.frag -o bin/shader/simple_shader.frag.spv
+glslc src/shader/frustum_cull.comp -o bin/shader/frustum_cull.comp.spv
+glslc src/shader/draw_compact.comp -o bin/shader/draw_compact.comp.spv
+glslc src/shader/light_cluster.comp -o bin/shader/light_cluster.comp.spv
@@ -1,11 +1,56 @@
 #include <cstdlib>
 #include <iostream>
 #include <stdexcept>
+#include <string>
+#include <vector>
 
 #include "src/app/app.hpp"
+#include "src/model/mesh_cache.hpp"
+#include "src/benchmark/benchmark.hpp"
 
 int main(int argc, char const *argv[])
 {
+    // bakes the mesh caches of the given models and exits: engine.out --convert-meshes models/a.obj ...
+    if (argc > 1 && std::string(argv[1]) == "--convert-meshes") {
+        try {
+            nugiEngine::EngineThreadPool threadPool{};
+
+            for (int i = 2; i < argc; i++) {
+                nugiEngine::EngineMeshCache::convert(argv[i], threadPool);
+            }
+        } catch(const std::exception &e) {
+            std::cerr << e.what() << "\n";
+            return EXIT_FAILURE;
+        }
+
+        return EXIT_SUCCESS;
+    }
+
+    // times the transform matrix paths and exits: engine.out --bench-transforms [count]
+    if (argc > 1 && std::string(argv[1]) == "--bench-transforms") {
+        try {
+            uint32_t count = argc > 2 ? static_cast<uint32_t>(std::stoul(argv[2])) : 100000;
+            nugiEngine::EngineBenchmark::transforms(count);
+        } catch(const std::exception &e) {
+            std::cerr << e.what() << "\n";
+            return EXIT_FAILURE;
+        }
+
+        return EXIT_SUCCESS;
+    }
+
+    // times the OBJ vertex dedup against the old unordered_map and exits: engine.out --bench-dedup models/a.obj ...
+    if (argc > 1 && std::string(argv[1]) == "--bench-dedup") {
+        try {
+            nugiEngine::EngineBenchmark::vertexDedup(std::vector<std::string>(argv + 2, argv + argc));
+        } catch(const std::exception &e) {
+            std::cerr << e.what() << "\n";
+            return EXIT_FAILURE;
+        }
+
+        return EXIT_SUCCESS;
+    }
+
     nugiEngine::EngineApp app{};
 
     try {
@@ -20,8 +20,14 @@
 namespace nugiEngine {
 	EngineApp::EngineApp() {
 		this->loadObjects();
-
-		this->renderer = std::make_unique<EngineRenderer>(this->window, this->device);
+		this->device.getUploadService()->flush();
+
+		// the main thread records the primary buffer, every worker its own secondaries
+		this->renderer = std::make_unique<EngineRenderer>(this->window, this->device, this->threadPool.getThreadCount() + 1);
+		this->cullingSystem = std::make_unique<EngineCullingSystem>(this->device, *this->renderer->getDescriptorPool(), *this->renderer->getFrameAllocator());
+		this->lightClusterSystem = std::make_unique<EngineLightClusterSystem>(this->device, *this->renderer->getDescriptorPool(), *this->renderer->getFrameAllocator(), 
+			*this->renderer->getLightClusterBuffer());
+		this->commandRecorder = std::make_unique<EngineCommandRecorder>(this->threadPool, *this->renderer->getCommandPoolManager());
 		this->recreateSubRendererAndSubsystem();
 	}
 
@@ -39,14 +45,30 @@ namespace nugiEngine {
 		auto currentTime = std::chrono::high_resolution_clock::now();
 		int t = 0;
 
+		EngineTaskGraph frameGraph{};
+
 		while (!this->window.shouldClose()) {
 			this->window.pollEvents();
+			this->device.getUploadService()->update();
 
 			auto newTime = std::chrono::high_resolution_clock::now();
 			float frameTime = std::chrono::duration<float, std::chrono::seconds::period>(newTime - currentTime).count();
 
 			if (t == 1000) {
-				std::string appTitle = std::string(APP_TITLE) + std::string(" | FPS: ") + std::to_string((1.0f / frameTime));
+				auto& cullingStats = this->cullingSystem->getStats();
+				auto& lightOverflow = this->lightClusterSystem->getOverflow();
+
+				std::string appTitle = std::string(APP_TITLE) + std::string(" | FPS: ") + std::to_string((1.0f / frameTime))
+					+ std::string(" | Culled: ") + std::to_string(cullingStats.testedCount - cullingStats.submittedCount) 
+					+ std::string("/") + std::to_string(cullingStats.testedCount)
+					+ std::string(" | Lights: ") + std::to_string(this->lightClusterSystem->getLightCount());
+
+				// lights past MAX_LIGHTS_PER_CLUSTER are dropped from their cluster, show when that happens
+				if (lightOverflow.clusterCount > 0) {
+					appTitle += std::string(" | Full clusters: ") + std::to_string(lightOverflow.clusterCount) 
+						+ std::string(" (up to ") + std::to_string(lightOverflow.maxLightCount) + std::string(" lights)");
+				}
+
 				glfwSetWindowTitle(this->window.getWindow(), appTitle.c_str());
 
 				t = 0;
@@ -74,24 +96,69 @@ namespace nugiEngine {
 					camera
 				};
 
-				// update
+				frameInfo.frameAllocator = this->renderer->getFrameAllocator();
+
 				GlobalUBO ubo{};
 				ubo.projection = camera.getProjectionMatrix();
 				ubo.view = camera.getViewMatrix();
 				ubo.inverseView = camera.getInverseViewMatrix();
-				this->renderer->writeUniformBuffer(frameIndex, &ubo);
+				frameInfo.globalUboOffset = this->renderer->getFrameAllocator()->write(ubo);
 
-				GlobalLight lightingObjects{};
-				this->pointLightRenderSystem->update(frameInfo, this->gameObjects, lightingObjects);
-				this->renderer->writeLightBuffer(frameIndex, &lightingObjects);
+				// the frame as a task graph: light update & CPU culling run side by side, the render
+				// systems record their secondary buffers as soon as the data they read is ready
+				VkRenderPass renderPass = this->swapChainSubRenderer->getRenderPass()->getRenderPass();
+				VkFramebuffer framebuffer = this->swapChainSubRenderer->getRenderPass()->getFramebuffers(imageIndex);
+				VkDescriptorSet globalDescSet = *this->renderer->getGlobalDescriptorSet();
 
-				// render
-				auto commandBuffer = this->renderer->beginCommand();
-				this->swapChainSubRenderer->beginRenderPass(commandBuffer, imageIndex);
+				std::shared_ptr<EngineCommandBuffer> commandBuffer{};
+
+				frameGraph.clear();
+				this->commandRecorder->beginFrame(frameIndex);
+
+				auto animateTask = frameGraph.addTask([&](uint32_t threadIndex) {
+					this->pointLightRenderSystem->update(frameInfo, this->scene);
+				});
+
+				// the lights move their transforms, so the dirty matrices & their subtrees are rebuilt after them
+				auto transformTask = frameGraph.addTask([&](uint32_t threadIndex) {
+					this->scene.getTransforms().updateMatrices(this->threadPool);
+				}, { animateTask });
+
+				auto lightTask = frameGraph.addTask([&](uint32_t threadIndex) {
+					this->lightClusterSystem->prepare(frameInfo, this->scene, this->renderer->getSwapChain()->getSwapChainExtent());
+				}, { transformTask });
+
+				auto cullTask = frameGraph.addTask([&](uint32_t threadIndex) {
+					this->cullingSystem->prepare(frameInfo, this->threadPool);
+				}, { transformTask });
+
+				frameGraph.addTask([&](uint32_t threadIndex) {
+					commandBuffer = this->renderer->beginCommand();
+					this->cullingSystem->cull(commandBuffer, ubo);
+					this->lightClusterSystem->cluster(commandBuffer, frameInfo);
+
+					this->swapChainSubRenderer->beginRenderPass(commandBuffer, imageIndex, VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS);
+				}, { lightTask, cullTask });
+
+				this->commandRecorder->record(frameGraph, { lightTask, cullTask }, renderPass, framebuffer, [&](std::shared_ptr<EngineCommandBuffer> secondaryCommandBuffer) {
+					this->swapChainSubRenderer->setViewportAndScissor(secondaryCommandBuffer);
+					this->simpleRenderSystem->render(secondaryCommandBuffer, globalDescSet, frameInfo, *this->cullingSystem);
+				});
+
+				this->commandRecorder->record(frameGraph, { lightTask, cullTask }, renderPass, framebuffer, [&](std::shared_ptr<EngineCommandBuffer> secondaryCommandBuffer) {
+					this->swapChainSubRenderer->setViewportAndScissor(secondaryCommandBuffer);
+					this->textureRenderSystem->render(secondaryCommandBuffer, globalDescSet, frameInfo, *this->cullingSystem);
+				});
+
+				this->commandRecorder->record(frameGraph, { lightTask }, renderPass, framebuffer, [&](std::shared_ptr<EngineCommandBuffer> secondaryCommandBuffer) {
+					this->swapChainSubRenderer->setViewportAndScissor(secondaryCommandBuffer);
+					this->pointLightRenderSystem->render(secondaryCommandBuffer, globalDescSet, frameInfo, this->scene);
+				});
 
-				this->simpleRenderSystem->render(commandBuffer, *this->renderer->getGlobalDescriptorSets(frameIndex), frameInfo, this->gameObjects);
-				this->textureRenderSystem->render(commandBuffer, *this->renderer->getGlobalDescriptorSets(frameIndex), frameInfo, this->gameObjects);
-				this->pointLightRenderSystem->render(commandBuffer, *this->renderer->getGlobalDescriptorSets(frameIndex), frameInfo, this->gameObjects);
+				frameGraph.run(this->threadPool);
+
+				// render
+				this->commandRecorder->executeCommands(commandBuffer);
 				
 				this->swapChainSubRenderer->endRenderPass(commandBuffer);
 				this->renderer->endCommand(commandBuffer);
@@ -99,8 +166,11 @@ namespace nugiEngine {
 				this->renderer->submitCommand(commandBuffer);
 
 				if (!this->renderer->presentFrame()) {
-					this->recreateSubRendererAndSubsystem();
+					this->resizeSubRenderer();
 				}
+			} else {
+				// the swap chain was out of date and has been recreated
+				this->resizeSubRenderer();
 			}
 		}
 
@@ -108,47 +178,31 @@ namespace nugiEngine {
 	}
 
 	void EngineApp::loadObjects() {
-		std::shared_ptr<EngineModel> flatVaseModel = EngineModel::createModelFromFile(this->device, "models/flat_vase.obj");
-
-		auto flatVase = EngineGameObject::createSharedGameObject();
-		flatVase->model = flatVaseModel;
-		flatVase->transform.translation = {-0.5f, 0.5f, 0.0f};
-		flatVase->transform.scale = {3.0f, 1.5f, 3.0f};
-		flatVase->color = {1.0f, 1.0f, 1.0f};
+		std::shared_ptr<EngineModel> flatVaseModel = EngineModel::createModelFromFile(this->device, this->geometryPool, "models/flat_vase.obj", this->threadPool);
 
-		this->gameObjects.push_back(std::move(flatVase)); 
+		auto flatVase = this->scene.createEntity();
+		this->scene.getTransforms().add(flatVase, {-0.5f, 0.5f, 0.0f}, glm::vec3{0.0f}, {3.0f, 1.5f, 3.0f});
+		this->scene.getModels().add(flatVase, ModelComponent{flatVaseModel});
 
-		std::shared_ptr<EngineModel> smoothVaseModel = EngineModel::createModelFromFile(this->device, "models/smooth_vase.obj");
+		std::shared_ptr<EngineModel> smoothVaseModel = EngineModel::createModelFromFile(this->device, this->geometryPool, "models/smooth_vase.obj", this->threadPool);
 
-		auto smoothVase = EngineGameObject::createSharedGameObject();
-		smoothVase->model = smoothVaseModel;
-		smoothVase->transform.translation = {0.5f, 0.5f, 0.0f};
-		smoothVase->transform.scale = {3.0f, 1.5f, 3.0f};
-		smoothVase->color = {1.0f, 1.0f, 1.0f};
+		auto smoothVase = this->scene.createEntity();
+		this->scene.getTransforms().add(smoothVase, {0.5f, 0.5f, 0.0f}, glm::vec3{0.0f}, {3.0f, 1.5f, 3.0f});
+		this->scene.getModels().add(smoothVase, ModelComponent{smoothVaseModel});
 
-		this->gameObjects.push_back(std::move(smoothVase));
-
-		std::shared_ptr<EngineModel> vikingRoomModel = EngineModel::createModelFromFile(this->device, "models/viking_room.obj");
+		std::shared_ptr<EngineModel> vikingRoomModel = EngineModel::createModelFromFile(this->device, this->geometryPool, "models/viking_room.obj", this->threadPool);
 		std::shared_ptr<EngineTexture> vikingRoomtexture = std::make_shared<EngineTexture>(this->device, "textures/viking_room.png");
 
-		auto vikingRoom = EngineGameObject::createSharedGameObject();
-		vikingRoom->model = vikingRoomModel;
-		vikingRoom->texture = vikingRoomtexture;
-		vikingRoom->transform.translation = {0.0f, -1.0f, -3.0f};
-		vikingRoom->transform.scale = {1.0f, 1.0f, 1.0f};
-		vikingRoom->color = {1.0f, 1.0f, 1.0f};
-
-		this->gameObjects.push_back(std::move(vikingRoom)); 
+		auto vikingRoom = this->scene.createEntity();
+		this->scene.getTransforms().add(vikingRoom, {0.0f, -1.0f, -3.0f});
+		this->scene.getModels().add(vikingRoom, ModelComponent{vikingRoomModel});
+		this->scene.getTextures().add(vikingRoom, TextureComponent{vikingRoomtexture});
 
-		std::shared_ptr<EngineModel> floorModel = EngineModel::createModelFromFile(this->device, "models/quad.obj");
+		std::shared_ptr<EngineModel> floorModel = EngineModel::createModelFromFile(this->device, this->geometryPool, "models/quad.obj", this->threadPool);
 
-		auto floor = EngineGameObject::createSharedGameObject();
-		floor->model = floorModel;
-		floor->transform.translation = {0.0f, 0.5f, 0.0f};
-		floor->transform.scale = {3.0f, 1.0f, 3.0f};
-		floor->color = {1.0f, 1.0f, 1.0f};
-
-		this->gameObjects.push_back(std::move(floor));
+		auto floor = this->scene.createEntity();
+		this->scene.getTransforms().add(floor, {0.0f, 0.5f, 0.0f}, glm::vec3{0.0f}, {3.0f, 1.0f, 3.0f});
+		this->scene.getModels().add(floor, ModelComponent{floorModel});
 
 		std::vector<glm::vec3> lightColors{
 			{1.f, .1f, .1f},
@@ -166,11 +220,9 @@ namespace nugiEngine {
 				{0.f, -1.f, 0.f}
 			);
 
-			auto pointLight = EngineGameObject::createSharedPointLight(0.5f, 0.05f);
-			pointLight->color = lightColors[i];
-			pointLight->transform.translation = glm::vec3(rotateLight * glm::vec4(-1.f, -1.f, -1.f, 1.f));
-
-			this->gameObjects.push_back(pointLight);
+			auto pointLight = this->scene.createEntity();
+			this->scene.getTransforms().add(pointLight, glm::vec3(rotateLight * glm::vec4(-1.f, -1.f, -1.f, 1.f)));
+			this->scene.getPointLights().add(pointLight, PointLightComponent{lightColors[i], 0.5f, 0.05f});
 		}
 	}
 
@@ -179,21 +231,34 @@ namespace nugiEngine {
 			this->renderer->getSwapChain()->getSwapChainImageFormat(), this->renderer->getSwapChain()->imageCount(), 
 			this->renderer->getSwapChain()->width(), this->renderer->getSwapChain()->height());
 
+		this->recreateRenderSystems();
+	}
+
+	void EngineApp::recreateRenderSystems() {
 		this->simpleRenderSystem = std::make_unique<EngineSimpleRenderSystem>(this->device, this->swapChainSubRenderer->getRenderPass()->getRenderPass(), this->renderer->getglobalDescSetLayout()->getDescriptorSetLayout());
 		this->pointLightRenderSystem = std::make_unique<EnginePointLightRenderSystem>(this->device, this->swapChainSubRenderer->getRenderPass()->getRenderPass(), this->renderer->getglobalDescSetLayout()->getDescriptorSetLayout());
 
-		std::vector<std::shared_ptr<EngineGameObject>> texturedGameObjects{};
-		for (auto& obj : this->gameObjects) {
-			if (obj->texture != nullptr) {
-				auto& texturedGameObject = obj;
-				texturedGameObjects.push_back(texturedGameObject);
+		this->textureRenderSystem = std::make_unique<EngineTextureRenderSystem>(this->device, this->swapChainSubRenderer->getRenderPass()->getRenderPass(), this->renderer->getglobalDescSetLayout()->getDescriptorSetLayout());
+
+		// the new texture set layout is identical to the old one, so sets that already exist stay valid
+		for (auto& texture : this->scene.getTextures().getComponents()) {
+			if (texture.texture != nullptr && texture.textureDescSet == nullptr) {
+				texture.textureDescSet = this->textureRenderSystem->setupTextureDescriptorSet(*this->renderer->getDescriptorPool(), texture.texture->getDescriptorInfo());
 			}
 		}
 
-		this->textureRenderSystem = std::make_unique<EngineTextureRenderSystem>(this->device, this->swapChainSubRenderer->getRenderPass()->getRenderPass(), this->renderer->getglobalDescSetLayout()->getDescriptorSetLayout());
+		this->cullingSystem->setScene(this->scene);
+	}
+
+	// viewport & scissor are dynamic, so while the render pass stays the same the pipelines are kept
+	void EngineApp::resizeSubRenderer() {
+		auto swapChain = this->renderer->getSwapChain();
+
+		bool isRenderPassKept = this->swapChainSubRenderer->resize(swapChain->getswapChainImages(), swapChain->getSwapChainImageFormat(), 
+			swapChain->imageCount(), swapChain->width(), swapChain->height());
 
-		for (auto& obj : texturedGameObjects) {
-			obj->textureDescSet = this->textureRenderSystem->setupTextureDescriptorSet(*this->renderer->getDescriptorPool(), obj->texture->getDescriptorInfo());
+		if (!isRenderPassKept) {
+			this->recreateRenderSystems();
 		}
 	}
 }
\ No newline at end of file
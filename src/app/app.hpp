@@ -3,12 +3,19 @@
 #include "../window/window.hpp"
 #include "../device/device.hpp"
 #include "../game_object/game_object.hpp"
+#include "../scene/scene.hpp"
+#include "../model/geometry_pool.hpp"
 #include "../renderer/renderer.hpp"
 #include "../descriptor/descriptor.hpp"
 #include "../renderer_system/simple_render_system.hpp"
 #include "../renderer_system/texture_render_system.hpp"
 #include "../renderer_system/point_light_render_system.hpp"
+#include "../renderer_system/culling_system.hpp"
+#include "../renderer_system/light_cluster_system.hpp"
 #include "../renderer_sub/swapchain_sub_renderer.hpp"
+#include "../thread/thread_pool.hpp"
+#include "../thread/task_graph.hpp"
+#include "../command/command_recorder.hpp"
 
 #include <memory>
 #include <vector>
@@ -33,17 +40,26 @@ namespace nugiEngine {
 		private:
 			void loadObjects();
 			void recreateSubRendererAndSubsystem();
+			void recreateRenderSystems();
+			void resizeSubRenderer();
 
 			EngineWindow window{WIDTH, HEIGHT, APP_TITLE};
 			EngineDevice device{window};
+			EngineThreadPool threadPool{};
+
+			// 44 MiB of vertices, 16 MiB of indices
+			std::shared_ptr<EngineGeometryPool> geometryPool = std::make_shared<EngineGeometryPool>(device, 1024 * 1024, 4 * 1024 * 1024);
 			
 			std::unique_ptr<EngineRenderer> renderer{};
 			std::unique_ptr<EngineSwapChainSubRenderer> swapChainSubRenderer{};
+			std::unique_ptr<EngineCullingSystem> cullingSystem{};
+			std::unique_ptr<EngineLightClusterSystem> lightClusterSystem{};
+			std::unique_ptr<EngineCommandRecorder> commandRecorder{};
 
 			std::unique_ptr<EngineSimpleRenderSystem> simpleRenderSystem{};
 			std::unique_ptr<EngineTextureRenderSystem> textureRenderSystem{};
 			std::unique_ptr<EnginePointLightRenderSystem> pointLightRenderSystem{};
 
-			std::vector<std::shared_ptr<EngineGameObject>> gameObjects;
+			EngineScene scene{};
 	};
 }
\ No newline at end of file
@@ -0,0 +1,206 @@
+#include "benchmark.hpp"
+#include "../game_object/game_object.hpp"
+#include "../game_object/transform_batch.hpp"
+#include "../model/obj_loader.hpp"
+#include "../model/vertex_dedup.hpp"
+#include "../thread/thread_pool.hpp"
+#include "../utils/utils.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+#define GLM_ENABLE_EXPERIMENTAL
+#include <glm/gtx/hash.hpp>
+
+namespace nugiEngine
+{
+	// fastest of repeatCount runs in nanoseconds per item; prepare runs untimed before each one
+	static double timeBest(uint32_t repeatCount, uint32_t itemCount, const std::function<void()> &prepare, const std::function<void()> &run) {
+		double best = std::numeric_limits<double>::max();
+
+		for (uint32_t repeat = 0; repeat < repeatCount; repeat++) {
+			prepare();
+
+			auto start = std::chrono::steady_clock::now();
+			run();
+			auto end = std::chrono::steady_clock::now();
+
+			best = std::min(best, std::chrono::duration<double, std::nano>(end - start).count());
+		}
+
+		return best / std::max(itemCount, 1u);
+	}
+
+	// the std::hash<Vertex> specialization loadModel used with its unordered_map
+	struct LegacyVertexHash {
+		size_t operator () (const Vertex &vertex) const {
+			size_t seed = 0;
+			hashCombine(seed, vertex.position, vertex.color, vertex.normal, vertex.uv);
+			return seed;
+		}
+	};
+
+	static float maxDifference(const std::vector<glm::mat4> &a, const std::vector<glm::mat4> &b) {
+		float difference = 0.0f;
+
+		for (size_t i = 0; i < a.size(); i++) {
+			for (int column = 0; column < 4; column++) {
+				for (int row = 0; row < 4; row++) {
+					difference = std::max(difference, std::abs(a[i][column][row] - b[i][column][row]));
+				}
+			}
+		}
+
+		return difference;
+	}
+
+	void EngineBenchmark::transforms(uint32_t count, uint32_t repeatCount) {
+		std::mt19937 random{1234};
+		std::uniform_real_distribution<float> position{-100.0f, 100.0f};
+		std::uniform_real_distribution<float> angle{-3.14159265f, 3.14159265f};
+		std::uniform_real_distribution<float> scale{0.1f, 4.0f};
+
+		std::vector<float> translationX(count), translationY(count), translationZ(count);
+		std::vector<float> rotationX(count), rotationY(count), rotationZ(count);
+		std::vector<float> scaleX(count), scaleY(count), scaleZ(count);
+
+		for (uint32_t i = 0; i < count; i++) {
+			translationX[i] = position(random);
+			translationY[i] = position(random);
+			translationZ[i] = position(random);
+			rotationX[i] = angle(random);
+			rotationY[i] = angle(random);
+			rotationZ[i] = angle(random);
+			scaleX[i] = scale(random);
+			scaleY[i] = scale(random);
+			scaleZ[i] = scale(random);
+		}
+
+		EngineTransformStreams streams{ translationX.data(), translationY.data(), translationZ.data(), 
+			rotationX.data(), rotationY.data(), rotationZ.data(), scaleX.data(), scaleY.data(), scaleZ.data() };
+
+		std::vector<TransformComponent> components(count);
+		for (uint32_t i = 0; i < count; i++) {
+			components[i].translation = glm::vec3{translationX[i], translationY[i], translationZ[i]};
+			components[i].rotation = glm::vec3{rotationX[i], rotationY[i], rotationZ[i]};
+			components[i].scale = glm::vec3{scaleX[i], scaleY[i], scaleZ[i]};
+		}
+
+		std::vector<glm::mat4> kernelModels(count), kernelNormals(count);
+		std::vector<glm::mat4> scalarModels(count), scalarNormals(count);
+		std::vector<glm::mat4> componentModels(count);
+		std::vector<glm::mat3> componentNormals(count);
+
+		// a small turn before every run dirties all of them, as an animated scene would
+		auto turn = [&]() {
+			for (uint32_t i = 0; i < count; i++) {
+				rotationY[i] += 0.001f;
+				components[i].rotation.y = rotationY[i];
+			}
+		};
+
+		auto keep = []() {};
+
+		double kernelTime = timeBest(repeatCount, count, turn, [&]() {
+			computeTransformMatrices(streams, count, kernelModels.data(), kernelNormals.data());
+		});
+
+		double scalarTime = timeBest(repeatCount, count, turn, [&]() {
+			computeTransformMatricesScalar(streams, 0, count, scalarModels.data(), scalarNormals.data());
+		});
+
+		double componentTime = timeBest(repeatCount, count, turn, [&]() {
+			for (uint32_t i = 0; i < count; i++) {
+				componentModels[i] = components[i].mat4();
+				componentNormals[i] = components[i].normalMatrix();
+			}
+		});
+
+		// nothing moved, so only the comparison against the cached values is left
+		double cachedTime = timeBest(repeatCount, count, keep, [&]() {
+			for (uint32_t i = 0; i < count; i++) {
+				componentModels[i] = components[i].mat4();
+				componentNormals[i] = components[i].normalMatrix();
+			}
+		});
+
+		// the last runs all saw the same rotations, so the outputs can be compared
+		computeTransformMatrices(streams, count, kernelModels.data(), kernelNormals.data());
+		computeTransformMatricesScalar(streams, 0, count, scalarModels.data(), scalarNormals.data());
+
+		std::cout << std::fixed << std::setprecision(2);
+		std::cout << "transforms: " << count << ", best of " << repeatCount << " runs, ns per transform (model & normal matrix)\n";
+		std::cout << "  computeTransformMatrices        " << kernelTime << "\n";
+		std::cout << "  computeTransformMatricesScalar  " << scalarTime << "  (" << scalarTime / kernelTime << "x the kernel)\n";
+		std::cout << "  TransformComponent::mat4()      " << componentTime << "  (" << componentTime / kernelTime << "x the kernel)\n";
+		std::cout << "  TransformComponent::mat4() hit  " << cachedTime << "  (unchanged, cached)\n";
+		std::cout << std::scientific << std::setprecision(3);
+		std::cout << "  kernel vs scalar max difference " << std::max(maxDifference(kernelModels, scalarModels), maxDifference(kernelNormals, scalarNormals)) << "\n";
+		std::cout << "  kernel vs component difference  " << maxDifference(kernelModels, componentModels) << "\n";
+	}
+
+	void EngineBenchmark::vertexDedup(const std::vector<std::string> &filePaths, uint32_t repeatCount) {
+		EngineThreadPool threadPool{};
+		auto nothing = []() {};
+
+		for (const auto &filePath : filePaths) {
+			std::vector<Vertex> loadedVertices;
+			std::vector<uint32_t> loadedIndices;
+			EngineObjLoader::load(filePath, threadPool, loadedVertices, loadedIndices);
+
+			// expanded back to one vertex per face corner, what the dedup sees while loading
+			std::vector<Vertex> corners(loadedIndices.size());
+			for (size_t i = 0; i < loadedIndices.size(); i++) {
+				corners[i] = loadedVertices[loadedIndices[i]];
+			}
+
+			uint32_t cornerCount = static_cast<uint32_t>(corners.size());
+			std::vector<Vertex> vertices;
+			std::vector<uint32_t> indices;
+
+			// the removed path as it was: count, then operator[] for the new and the found vertex alike
+			double mapTime = timeBest(repeatCount, cornerCount, nothing, [&]() {
+				std::unordered_map<Vertex, uint32_t, LegacyVertexHash> uniqueVertices{};
+				vertices.clear();
+				indices.clear();
+
+				for (const auto &vertex : corners) {
+					if (uniqueVertices.count(vertex) == 0) {
+						uniqueVertices[vertex] = static_cast<uint32_t>(vertices.size());
+						vertices.push_back(vertex);
+					}
+
+					indices.push_back(uniqueVertices[vertex]);
+				}
+			});
+
+			size_t mapVertexCount = vertices.size();
+
+			double tableTime = timeBest(repeatCount, cornerCount, nothing, [&]() {
+				vertices.clear();
+				indices.clear();
+				indices.reserve(corners.size());
+
+				EngineVertexDedupTable uniqueVertices{vertices, corners.size()};
+				for (const auto &vertex : corners) {
+					indices.push_back(uniqueVertices.insertOrGet(vertex));
+				}
+			});
+
+			std::cout << std::fixed << std::setprecision(2);
+			std::cout << filePath << ": " << cornerCount << " corners, " << vertices.size() << " unique vertices (unordered_map: " 
+				<< mapVertexCount << "), best of " << repeatCount << " runs\n";
+			std::cout << "  std::unordered_map      " << mapTime * cornerCount / 1e6 << " ms, " << mapTime << " ns per corner\n";
+			std::cout << "  EngineVertexDedupTable  " << tableTime * cornerCount / 1e6 << " ms, " << tableTime << " ns per corner  (" 
+				<< mapTime / tableTime << "x faster)\n";
+		}
+	}
+} // namespace nugiEngine
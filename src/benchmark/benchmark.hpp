@@ -0,0 +1,24 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace nugiEngine
+{
+	/**
+	 * Timings of the engine's hot paths on synthetic data, run from the command line instead of the
+	 * app. Every case is repeated and the fastest run is printed, so a cold first pass does not count.
+	 */
+	class EngineBenchmark
+	{
+	public:
+		// the batch kernel, its scalar path & TransformComponent::mat4() building count matrices;
+		// the rotations change before every run so no cache hides the work
+		static void transforms(uint32_t count, uint32_t repeatCount = 20);
+
+		// deduplicating the corner vertices of every OBJ file: EngineVertexDedupTable against the
+		// std::unordered_map<Vertex, uint32_t> loadModel used before it
+		static void vertexDedup(const std::vector<std::string> &filePaths, uint32_t repeatCount = 5);
+	};
+} // namespace nugiEngine
@@ -6,11 +6,11 @@
  */
  
 #include "buffer.hpp"
-#include "../command/command_buffer.hpp"
  
 // std
 #include <cassert>
 #include <cstring>
+#include <stdexcept>
  
 namespace nugiEngine {
   /**
@@ -52,12 +52,15 @@ namespace nugiEngine {
   EngineBuffer::~EngineBuffer() {
     this->unmap();
     vkDestroyBuffer(this->engineDevice.getLogicalDevice(), this->buffer, nullptr);
-    vkFreeMemory(this->engineDevice.getLogicalDevice(), this->memory, nullptr);
+    this->engineDevice.getMemoryAllocator()->free(this->memory);
   }
   
   /**
    * Map a memory range of this buffer. If successful, mapped points to the specified buffer range.
    *
+   * @note Host visible memory blocks are persistently mapped by the allocator, so this only
+   * hands out a pointer into the block
+   *
    * @param size (Optional) Size of the memory range to map. Pass VK_WHOLE_SIZE to map the complete
    * buffer range.
    * @param offset (Optional) Byte offset from beginning
@@ -65,8 +68,13 @@ namespace nugiEngine {
    * @return VkResult of the buffer mapping call
    */
   VkResult EngineBuffer::map(VkDeviceSize size, VkDeviceSize offset) {
-    assert(this->buffer && this->memory && "Called map on buffer before create");
-    return vkMapMemory(this->engineDevice.getLogicalDevice(), this->memory, offset, size, 0, &this->mapped);
+    assert(this->buffer && this->memory.memory && "Called map on buffer before create");
+    if (this->memory.mapped == nullptr) {
+      return VK_ERROR_MEMORY_MAP_FAILED;
+    }
+
+    this->mapped = static_cast<char*>(this->memory.mapped) + offset;
+    return VK_SUCCESS;
   }
   
   /**
@@ -75,10 +83,7 @@ namespace nugiEngine {
    * @note Does not return a result as vkUnmapMemory can't fail
    */
   void EngineBuffer::unmap() {
-    if (this->mapped) {
-      vkUnmapMemory(this->engineDevice.getLogicalDevice(), this->memory);
-      this->mapped = nullptr;
-    }
+    this->mapped = nullptr;
   }
   
   /**
@@ -114,12 +119,7 @@ namespace nugiEngine {
    * @return VkResult of the flush call
    */
   VkResult EngineBuffer::flush(VkDeviceSize size, VkDeviceSize offset) {
-    VkMappedMemoryRange mappedRange = {};
-    mappedRange.sType = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE;
-    mappedRange.memory = this->memory;
-    mappedRange.offset = offset;
-    mappedRange.size = size;
-    return vkFlushMappedMemoryRanges(this->engineDevice.getLogicalDevice(), 1, &mappedRange);
+    return this->engineDevice.getMemoryAllocator()->flush(this->memory, size, offset);
   }
   
   /**
@@ -134,12 +134,7 @@ namespace nugiEngine {
    * @return VkResult of the invalidate call
    */
   VkResult EngineBuffer::invalidate(VkDeviceSize size, VkDeviceSize offset) {
-    VkMappedMemoryRange mappedRange = {};
-    mappedRange.sType = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE;
-    mappedRange.memory = this->memory;
-    mappedRange.offset = offset;
-    mappedRange.size = size;
-    return vkInvalidateMappedMemoryRanges(this->engineDevice.getLogicalDevice(), 1, &mappedRange);
+    return this->engineDevice.getMemoryAllocator()->invalidate(this->memory, size, offset);
   }
   
   /**
@@ -217,60 +212,11 @@ namespace nugiEngine {
     VkMemoryRequirements memRequirements;
     vkGetBufferMemoryRequirements(this->engineDevice.getLogicalDevice(), this->buffer, &memRequirements);
 
-    VkMemoryAllocateInfo allocInfo{};
-    allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-    allocInfo.allocationSize = memRequirements.size;
-    allocInfo.memoryTypeIndex = this->engineDevice.findMemoryType(memRequirements.memoryTypeBits, properties);
+    this->memory = this->engineDevice.getMemoryAllocator()->allocate(memRequirements, properties, EngineMemoryResourceKind::Linear);
 
-    if (vkAllocateMemory(this->engineDevice.getLogicalDevice(), &allocInfo, nullptr, &this->memory) != VK_SUCCESS) {
-      throw std::runtime_error("failed to allocate vertex buffer memory!");
+    if (vkBindBufferMemory(this->engineDevice.getLogicalDevice(), this->buffer, this->memory.memory, this->memory.offset) != VK_SUCCESS) {
+      throw std::runtime_error("failed to bind buffer memory!");
     }
-
-    vkBindBufferMemory(this->engineDevice.getLogicalDevice(), this->buffer, this->memory, 0);
-  }
-
-  void EngineBuffer::copyBuffer(VkBuffer srcBuffer, VkDeviceSize size) {
-    EngineCommandBuffer commandBuffer{this->engineDevice};
-    commandBuffer.beginSingleTimeCommand();
-
-    VkBufferCopy copyRegion{};
-    copyRegion.srcOffset = 0;  // Optional
-    copyRegion.dstOffset = 0;  // Optional
-    copyRegion.size = size;
-    vkCmdCopyBuffer(commandBuffer.getCommandBuffer(), srcBuffer, this->buffer, 1, &copyRegion);
-
-    commandBuffer.endCommand();
-    commandBuffer.submitCommand(this->engineDevice.getGraphicsQueue());
-  }
-
-  void EngineBuffer::copyBufferToImage(VkImage image, uint32_t width, uint32_t height, uint32_t layerCount) {
-    EngineCommandBuffer commandBuffer{this->engineDevice};
-    commandBuffer.beginSingleTimeCommand();
-
-    VkBufferImageCopy region{};
-    region.bufferOffset = 0;
-    region.bufferRowLength = 0;
-    region.bufferImageHeight = 0;
-
-    region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-    region.imageSubresource.mipLevel = 0;
-    region.imageSubresource.baseArrayLayer = 0;
-    region.imageSubresource.layerCount = layerCount;
-
-    region.imageOffset = {0, 0, 0};
-    region.imageExtent = {width, height, 1};
-
-    vkCmdCopyBufferToImage(
-      commandBuffer.getCommandBuffer(),
-      this->buffer,
-      image,
-      VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-      1,
-      &region
-    );
-
-    commandBuffer.endCommand();
-    commandBuffer.submitCommand(this->engineDevice.getGraphicsQueue());
   }
   
  
@@ -19,8 +19,6 @@ class EngineBuffer {
   EngineBuffer& operator=(const EngineBuffer&) = delete;
 
   void createBuffer(VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties);
-  void copyBuffer(VkBuffer srcBuffer, VkDeviceSize size);
-  void copyBufferToImage(VkImage image, uint32_t width, uint32_t height, uint32_t layerCount);
  
   VkResult map(VkDeviceSize size = VK_WHOLE_SIZE, VkDeviceSize offset = 0);
   void unmap();
@@ -39,7 +37,7 @@ class EngineBuffer {
   void* getMappedMemory() const { return mapped; }
   uint32_t getInstanceCount() const { return instanceCount; }
   VkDeviceSize getInstanceSize() const { return instanceSize; }
-  VkDeviceSize getAlignmentSize() const { return instanceSize; }
+  VkDeviceSize getAlignmentSize() const { return alignmentSize; }
   VkBufferUsageFlags getUsageFlags() const { return usageFlags; }
   VkMemoryPropertyFlags getMemoryPropertyFlags() const { return memoryPropertyFlags; }
   VkDeviceSize getBufferSize() const { return bufferSize; }
@@ -51,7 +49,7 @@ class EngineBuffer {
 
   void* mapped = nullptr;
   VkBuffer buffer = VK_NULL_HANDLE;
-  VkDeviceMemory memory = VK_NULL_HANDLE;
+  EngineMemoryAllocation memory;
  
   VkDeviceSize bufferSize;
   uint32_t instanceCount;
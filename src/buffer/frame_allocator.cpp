@@ -0,0 +1,74 @@
+#include "frame_allocator.hpp"
+
+// std
+#include <algorithm>
+#include <cassert>
+#include <stdexcept>
+
+namespace nugiEngine {
+  EngineFrameAllocator::EngineFrameAllocator(EngineDevice &device, VkDeviceSize frameCapacity, VkDeviceSize maxBindingRange, uint32_t frameCount, VkBufferUsageFlags usageFlags) {
+    auto limits = device.getProperties().limits;
+
+    this->alignment = std::max<VkDeviceSize>(limits.minUniformBufferOffsetAlignment, 1);
+    if (usageFlags & VK_BUFFER_USAGE_STORAGE_BUFFER_BIT) {
+      this->alignment = std::max<VkDeviceSize>(this->alignment, limits.minStorageBufferOffsetAlignment);
+    }
+
+    // keep every frame region starting on an aligned offset
+    this->frameCapacity = (frameCapacity + this->alignment - 1) / this->alignment * this->alignment;
+    this->maxBindingRange = (maxBindingRange + this->alignment - 1) / this->alignment * this->alignment;
+
+    // an allocation may start right at the end of the capacity, so a full range bound there
+    // has to land in the spare tail of its own region
+    this->frameStride = this->frameCapacity + this->maxBindingRange;
+
+    this->buffer = std::make_unique<EngineBuffer>(
+      device,
+      this->frameStride,
+      frameCount,
+      usageFlags,
+      VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT
+    );
+
+    this->buffer->map();
+  }
+
+  void EngineFrameAllocator::beginFrame(uint32_t frameIndex) {
+    this->frameStart = frameIndex * this->frameStride;
+    this->head = this->frameStart;
+  }
+
+  EngineFrameAllocation EngineFrameAllocator::allocate(VkDeviceSize size) {
+    // every size is rounded up, so the head always stays aligned and one atomic add is enough
+    VkDeviceSize alignedSize = (size + this->alignment - 1) / this->alignment * this->alignment;
+    VkDeviceSize offset = this->head.fetch_add(alignedSize);
+
+    if (offset + size > this->frameStart + this->frameCapacity) {
+      throw std::runtime_error("frame allocator is out of memory for this frame!");
+    }
+
+    assert(offset + this->maxBindingRange <= this->frameStart + this->frameStride && "Binding range would leave the frame region");
+
+    EngineFrameAllocation allocation{};
+    allocation.offset = offset;
+    allocation.size = size;
+    allocation.mapped = static_cast<char*>(this->buffer->getMappedMemory()) + offset;
+
+    return allocation;
+  }
+
+  VkDescriptorBufferInfo EngineFrameAllocator::descriptorInfo(VkDeviceSize range) const {
+    assert(range != VK_WHOLE_SIZE && range <= this->maxBindingRange && "Dynamic descriptors need a range that fits the frame region tail");
+    return VkDescriptorBufferInfo{ this->buffer->getBuffer(), 0, range };
+  }
+
+  VkResult EngineFrameAllocator::flush() {
+    VkDeviceSize usedSize = std::min(this->head.load(), this->frameStart + this->frameCapacity) - this->frameStart;
+    if (usedSize == 0) {
+      return VK_SUCCESS;
+    }
+
+    return this->buffer->flush(usedSize, this->frameStart);
+  }
+
+} // namespace nugiEngine
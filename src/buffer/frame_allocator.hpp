@@ -0,0 +1,62 @@
+#pragma once
+
+#include "buffer.hpp"
+
+#include <atomic>
+#include <memory>
+
+namespace nugiEngine {
+  struct EngineFrameAllocation {
+    VkDeviceSize offset = 0;
+    VkDeviceSize size = 0;
+    void* mapped = nullptr;
+
+    // offset to pass to vkCmdBindDescriptorSets for a dynamic descriptor bound at offset 0
+    uint32_t dynamicOffset() const { return static_cast<uint32_t>(this->offset); }
+  };
+
+  /**
+   * Linear allocator over one persistently mapped buffer, split into one region per frame in flight.
+   * Everything allocated during a frame is thrown away at once when that frame index comes around
+   * again, which is safe because the renderer has waited for the frame's fence by then.
+   * allocate() may be called from several threads during a frame, beginFrame() and flush() may not.
+   *
+   * Dynamic descriptors over this buffer use a fixed range of at most maxBindingRange, and every frame
+   * region carries that many spare bytes past its capacity, so offset + range never leaves the region.
+   */
+  class EngineFrameAllocator {
+    public:
+      EngineFrameAllocator(EngineDevice &device, VkDeviceSize frameCapacity, VkDeviceSize maxBindingRange, uint32_t frameCount, VkBufferUsageFlags usageFlags);
+
+      EngineFrameAllocator(const EngineFrameAllocator&) = delete;
+      EngineFrameAllocator& operator=(const EngineFrameAllocator&) = delete;
+
+      void beginFrame(uint32_t frameIndex);
+      EngineFrameAllocation allocate(VkDeviceSize size);
+      VkResult flush();
+
+      template<typename T>
+      uint32_t write(const T &data) {
+        EngineFrameAllocation allocation = this->allocate(sizeof(T));
+        *static_cast<T*>(allocation.mapped) = data;
+        return allocation.dynamicOffset();
+      }
+
+      VkDescriptorBufferInfo descriptorInfo(VkDeviceSize range) const;
+      VkBuffer getBuffer() const { return this->buffer->getBuffer(); }
+      VkDeviceSize getAlignment() const { return this->alignment; }
+      VkDeviceSize getMaxBindingRange() const { return this->maxBindingRange; }
+      VkDeviceSize getUsedSize() const { return this->head.load() - this->frameStart; }
+
+    private:
+      std::unique_ptr<EngineBuffer> buffer;
+
+      VkDeviceSize frameCapacity;
+      VkDeviceSize maxBindingRange;
+      VkDeviceSize frameStride;
+      VkDeviceSize alignment;
+      VkDeviceSize frameStart = 0;
+      std::atomic<VkDeviceSize> head{0};
+  };
+
+} // namespace nugiEngine
@@ -12,6 +12,9 @@ namespace nugiEngine {
     this->projectionMatrix[3][0] = -(right + left) / (right - left);
     this->projectionMatrix[3][1] = -(bottom + top) / (bottom - top);
     this->projectionMatrix[3][2] = -near / (far - near);
+
+    this->nearPlane = near;
+    this->farPlane = far;
   }
     
   void EngineCamera::setPerspectiveProjection(float fovy, float aspect, float near, float far) {
@@ -23,6 +26,9 @@ namespace nugiEngine {
     this->projectionMatrix[2][2] = far / (far - near);
     this->projectionMatrix[2][3] = 1.f;
     this->projectionMatrix[3][2] = -(far * near) / (far - near);
+
+    this->nearPlane = near;
+    this->farPlane = far;
   }
 
   void EngineCamera::setViewDirection(glm::vec3 position, glm::vec3 direction, glm::vec3 up) {
@@ -18,10 +18,16 @@ namespace nugiEngine {
       const glm::mat4 getViewMatrix() const { return this->viewMatrix; }
       const glm::mat4 getInverseViewMatrix() const { return this->inverseViewMatrix; }
 
+      float getNear() const { return this->nearPlane; }
+      float getFar() const { return this->farPlane; }
+
     private:
       glm::mat4 projectionMatrix{1.0f};
       glm::mat4 viewMatrix{1.0f};
       glm::mat4 inverseViewMatrix{1.0f};
+
+      float nearPlane = 0.1f;
+      float farPlane = 10.0f;
   };
 } // namespace nugiEngine
 
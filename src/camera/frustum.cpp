@@ -0,0 +1,70 @@
+#include "frustum.hpp"
+
+namespace nugiEngine {
+  EngineFrustum::EngineFrustum(const EngineCamera &camera) : EngineFrustum{camera.getProjectionMatrix() * camera.getViewMatrix()} {}
+
+  // Gribb-Hartmann extraction, clip space depth is 0..1
+  EngineFrustum::EngineFrustum(const glm::mat4 &viewProjection) {
+    glm::vec4 rows[4];
+    for (int i = 0; i < 4; i++) {
+      rows[i] = glm::vec4{viewProjection[0][i], viewProjection[1][i], viewProjection[2][i], viewProjection[3][i]};
+    }
+
+    glm::vec4 planes[PLANE_COUNT] = {
+      rows[3] + rows[0], // -x
+      rows[3] - rows[0], // +x
+      rows[3] + rows[1], // -y
+      rows[3] - rows[1], // +y
+      rows[2],           // near
+      rows[3] - rows[2]  // far
+    };
+
+    for (int i = 0; i < PLANE_COUNT; i++) {
+      glm::vec4 plane = planes[i] / glm::length(glm::vec3{planes[i]});
+
+      this->planeX[i] = plane.x;
+      this->planeY[i] = plane.y;
+      this->planeZ[i] = plane.z;
+      this->planeW[i] = plane.w;
+    }
+  }
+
+  bool EngineFrustum::testSphere(glm::vec3 center, float radius) const {
+    for (int i = 0; i < PLANE_COUNT; i++) {
+      float distance = this->planeX[i] * center.x + this->planeY[i] * center.y + this->planeZ[i] * center.z + this->planeW[i];
+      if (distance < -radius) return false;
+    }
+
+    return true;
+  }
+
+  bool EngineFrustum::testBox(glm::vec3 center, glm::vec3 extents) const {
+    for (int i = 0; i < PLANE_COUNT; i++) {
+      float distance = this->planeX[i] * center.x + this->planeY[i] * center.y + this->planeZ[i] * center.z + this->planeW[i];
+      float projectedRadius = glm::abs(this->planeX[i]) * extents.x + glm::abs(this->planeY[i]) * extents.y + glm::abs(this->planeZ[i]) * extents.z;
+
+      if (distance + projectedRadius < 0.0f) return false;
+    }
+
+    return true;
+  }
+
+  // no early out: the inner loop is branch free so the compiler can vectorize it
+  void EngineFrustum::testSpheres(const float *centerX, const float *centerY, const float *centerZ, const float *radius, uint8_t *visible, size_t count) const {
+    for (size_t j = 0; j < count; j++) {
+      visible[j] = 1;
+    }
+
+    for (int i = 0; i < PLANE_COUNT; i++) {
+      const float px = this->planeX[i];
+      const float py = this->planeY[i];
+      const float pz = this->planeZ[i];
+      const float pw = this->planeW[i];
+
+      for (size_t j = 0; j < count; j++) {
+        float distance = px * centerX[j] + py * centerY[j] + pz * centerZ[j] + pw;
+        visible[j] &= static_cast<uint8_t>(distance >= -radius[j]);
+      }
+    }
+  }
+} // namespace nugiEngine
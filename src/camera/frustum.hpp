@@ -0,0 +1,36 @@
+#pragma once
+
+#include "camera.hpp"
+
+#define GLM_FORCE_RADIANS
+#define GLM_FORCE_DEPTH_ZERO_TO_ONE
+#include <glm/glm.hpp>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace nugiEngine {
+  /**
+   * The six clip planes of a camera, normals pointing inwards. Planes are kept as separate
+   * x / y / z / w arrays so the batch test runs the same plane over many objects at once.
+   */
+  class EngineFrustum {
+    public:
+      static constexpr int PLANE_COUNT = 6;
+
+      EngineFrustum(const EngineCamera &camera);
+      EngineFrustum(const glm::mat4 &viewProjection);
+
+      bool testSphere(glm::vec3 center, float radius) const;
+      bool testBox(glm::vec3 center, glm::vec3 extents) const;
+
+      // world space spheres as separate arrays; visible[i] is set to 0 or 1
+      void testSpheres(const float *centerX, const float *centerY, const float *centerZ, const float *radius, uint8_t *visible, size_t count) const;
+
+    private:
+      float planeX[PLANE_COUNT];
+      float planeY[PLANE_COUNT];
+      float planeZ[PLANE_COUNT];
+      float planeW[PLANE_COUNT];
+  };
+} // namespace nugiEngine
@@ -6,7 +6,7 @@ namespace nugiEngine {
 	EngineCommandBuffer::~EngineCommandBuffer() {
 		vkFreeCommandBuffers(
       this->appDevice.getLogicalDevice(), 
-      this->appDevice.getCommandPool(), 
+      this->commandPool, 
       1, 
       &this->commandBuffer
     );
@@ -36,12 +36,12 @@ namespace nugiEngine {
 	}
 
 	EngineCommandBuffer::EngineCommandBuffer(EngineDevice& device, VkCommandBuffer commandBuffer) 
-		: appDevice{device}, commandBuffer {commandBuffer} 
+		: appDevice{device}, commandPool{device.getCommandPool()}, commandBuffer {commandBuffer} 
 	{
 
 	}
 
-	EngineCommandBuffer::EngineCommandBuffer(EngineDevice& device) : appDevice{device} {
+	EngineCommandBuffer::EngineCommandBuffer(EngineDevice& device) : appDevice{device}, commandPool{device.getCommandPool()} {
 		VkCommandBufferAllocateInfo allocInfo{};
 		allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
 		allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
@@ -53,6 +53,21 @@ namespace nugiEngine {
 		}
 	}
 
+	// for pools other than the device one, e.g. the per-thread pools secondary buffers are recorded from
+	EngineCommandBuffer::EngineCommandBuffer(EngineDevice& device, VkCommandPool commandPool, VkCommandBufferLevel level) 
+		: appDevice{device}, commandPool{commandPool} 
+	{
+		VkCommandBufferAllocateInfo allocInfo{};
+		allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+		allocInfo.level = level;
+		allocInfo.commandPool = commandPool;
+		allocInfo.commandBufferCount = 1;
+
+		if (vkAllocateCommandBuffers(appDevice.getLogicalDevice(), &allocInfo, &this->commandBuffer) != VK_SUCCESS) {
+			throw std::runtime_error("failed to allocate command buffer");
+		}
+	}
+
 	void EngineCommandBuffer::beginSingleTimeCommand() {
 		VkCommandBufferBeginInfo beginInfo{};
 		beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
@@ -72,6 +87,23 @@ namespace nugiEngine {
 		}
 	}
 
+	void EngineCommandBuffer::beginSecondaryCommand(VkRenderPass renderPass, uint32_t subpass, VkFramebuffer framebuffer) {
+		VkCommandBufferInheritanceInfo inheritanceInfo{};
+		inheritanceInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO;
+		inheritanceInfo.renderPass = renderPass;
+		inheritanceInfo.subpass = subpass;
+		inheritanceInfo.framebuffer = framebuffer;
+
+		VkCommandBufferBeginInfo beginInfo{};
+		beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+		beginInfo.flags = VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT | VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+		beginInfo.pInheritanceInfo = &inheritanceInfo;
+
+		if (vkBeginCommandBuffer(this->commandBuffer, &beginInfo) != VK_SUCCESS) {
+			std::cerr << "Failed to start recording secondary command buffer" << '\n';
+		}
+	}
+
 	void EngineCommandBuffer::endCommand() {
 		if (vkEndCommandBuffer(this->commandBuffer) != VK_SUCCESS) {
 			std::cerr << "Failed to end recording command buffer" << '\n';
@@ -107,9 +139,36 @@ namespace nugiEngine {
 		if (vkQueueSubmit(queue, 1, &submitInfo, fence) != VK_SUCCESS) {
 			std::cerr << "Failed to submitting command buffer" << '\n';
 		}
+	}
+
+	// Blocking submit for one-off work (uploads, layout transitions). Only waits for
+	// this submission, so frames already in flight on the same queue are not drained
+	void EngineCommandBuffer::submitCommandAndWait(VkQueue queue) {
+		VkFenceCreateInfo fenceInfo{};
+		fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+
+		VkFence fence;
+		if (vkCreateFence(this->appDevice.getLogicalDevice(), &fenceInfo, nullptr, &fence) != VK_SUCCESS) {
+			throw std::runtime_error("failed to create fence for command submission");
+		}
+
+		this->submitCommand(queue, {}, {}, {}, fence);
+
+		if (vkWaitForFences(this->appDevice.getLogicalDevice(), 1, &fence, VK_TRUE, UINT64_MAX) != VK_SUCCESS) {
+			std::cerr << "Failed to waiting command buffer" << '\n';
+		}
 
-		if (vkQueueWaitIdle(queue) != VK_SUCCESS) {
-			std::cerr << "Failed to waiting queue" << '\n';
+		vkDestroyFence(this->appDevice.getLogicalDevice(), fence, nullptr);
+	}
+
+	void EngineCommandBuffer::executeCommands(const std::vector<std::shared_ptr<EngineCommandBuffer>> &secondaryCommandBuffers) {
+		std::vector<VkCommandBuffer> buffers{};
+		for (auto& commandBuffer : secondaryCommandBuffers) {
+			buffers.push_back(commandBuffer->getCommandBuffer());
+		}
+
+		if (!buffers.empty()) {
+			vkCmdExecuteCommands(this->commandBuffer, static_cast<uint32_t>(buffers.size()), buffers.data());
 		}
 	}
 
@@ -147,10 +206,5 @@ namespace nugiEngine {
 		if (vkQueueSubmit(queue, 1, &submitInfo, fence) != VK_SUCCESS) {
 			std::cerr << "Failed to submitting command buffer" << '\n';
 		}
-
-		if (vkQueueWaitIdle(queue) != VK_SUCCESS) {
-			std::cerr << "Failed to waiting queue" << '\n';
-		}
-		
 	}
 } // namespace nugiEngine
@@ -11,6 +11,7 @@ namespace nugiEngine
     public:
       EngineCommandBuffer(EngineDevice& device, VkCommandBuffer commandBuffer);
       EngineCommandBuffer(EngineDevice& device);
+      EngineCommandBuffer(EngineDevice& device, VkCommandPool commandPool, VkCommandBufferLevel level);
 
       ~EngineCommandBuffer();
 
@@ -21,10 +22,13 @@ namespace nugiEngine
 
       void beginSingleTimeCommand();
       void beginReccuringCommand();
+      void beginSecondaryCommand(VkRenderPass renderPass, uint32_t subpass, VkFramebuffer framebuffer);
       void endCommand();
       void submitCommand(VkQueue queue, std::vector<VkSemaphore> waitSemaphores = {}, 
         std::vector<VkPipelineStageFlags> waitStages = {}, std::vector<VkSemaphore> signalSemaphores = {}, 
         VkFence fence = VK_NULL_HANDLE);
+      void submitCommandAndWait(VkQueue queue);
+      void executeCommands(const std::vector<std::shared_ptr<EngineCommandBuffer>> &secondaryCommandBuffers);
 
       static void submitCommands(std::vector<std::shared_ptr<EngineCommandBuffer>> commandBuffers, VkQueue queue, std::vector<VkSemaphore> waitSemaphores = {}, 
         std::vector<VkPipelineStageFlags> waitStages = {}, std::vector<VkSemaphore> signalSemaphores = {}, 
@@ -34,6 +38,7 @@ namespace nugiEngine
 
     private:
       EngineDevice& appDevice;
+      VkCommandPool commandPool;
       VkCommandBuffer commandBuffer;
   };
   
@@ -0,0 +1,61 @@
+#include "command_pool_manager.hpp"
+
+#include <stdexcept>
+
+namespace nugiEngine {
+  EngineCommandPoolManager::EngineCommandPoolManager(EngineDevice &device, uint32_t threadCount, uint32_t frameCount) 
+    : appDevice{device}, threadCount{threadCount}, frameCount{frameCount} 
+  {
+    QueueFamilyIndices queueFamilyIndices = device.findPhysicalQueueFamilies();
+    this->framePools.resize(threadCount * frameCount);
+
+    for (auto &framePool : this->framePools) {
+      // no RESET_COMMAND_BUFFER_BIT: buffers are only ever reset together with their pool
+      VkCommandPoolCreateInfo poolInfo = {};
+      poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+      poolInfo.queueFamilyIndex = queueFamilyIndices.graphicsFamily;
+      poolInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+
+      if (vkCreateCommandPool(device.getLogicalDevice(), &poolInfo, nullptr, &framePool.commandPool) != VK_SUCCESS) {
+        throw std::runtime_error("failed to create frame command pool!");
+      }
+    }
+  }
+
+  EngineCommandPoolManager::~EngineCommandPoolManager() {
+    for (auto &framePool : this->framePools) {
+      framePool.primaryCommandBuffers.clear();
+      framePool.secondaryCommandBuffers.clear();
+
+      vkDestroyCommandPool(this->appDevice.getLogicalDevice(), framePool.commandPool, nullptr);
+    }
+  }
+
+  void EngineCommandPoolManager::resetFrame(uint32_t frameIndex) {
+    for (uint32_t threadIndex = 0; threadIndex < this->threadCount; threadIndex++) {
+      auto &framePool = this->framePools[threadIndex * this->frameCount + frameIndex];
+      if (framePool.usedPrimaryCount == 0 && framePool.usedSecondaryCount == 0) continue;
+
+      if (vkResetCommandPool(this->appDevice.getLogicalDevice(), framePool.commandPool, 0) != VK_SUCCESS) {
+        throw std::runtime_error("failed to reset frame command pool!");
+      }
+
+      framePool.usedPrimaryCount = 0;
+      framePool.usedSecondaryCount = 0;
+    }
+  }
+
+  std::shared_ptr<EngineCommandBuffer> EngineCommandPoolManager::acquireCommandBuffer(uint32_t threadIndex, uint32_t frameIndex, VkCommandBufferLevel level) {
+    auto &framePool = this->framePools[threadIndex * this->frameCount + frameIndex];
+
+    bool isPrimary = level == VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+    auto &commandBuffers = isPrimary ? framePool.primaryCommandBuffers : framePool.secondaryCommandBuffers;
+    auto &usedCount = isPrimary ? framePool.usedPrimaryCount : framePool.usedSecondaryCount;
+
+    if (usedCount == commandBuffers.size()) {
+      commandBuffers.push_back(std::make_shared<EngineCommandBuffer>(this->appDevice, framePool.commandPool, level));
+    }
+
+    return commandBuffers[usedCount++];
+  }
+} // namespace nugiEngine
@@ -0,0 +1,47 @@
+#pragma once
+
+#include "command_buffer.hpp"
+
+#include <memory>
+#include <vector>
+
+namespace nugiEngine
+{
+  // One command pool for every recording thread and frame in flight. Pools are reset as a whole
+  // once the fence of their frame has signaled, and the command buffers allocated from them are
+  // handed out again instead of being freed & reallocated
+  class EngineCommandPoolManager {
+    public:
+      EngineCommandPoolManager(EngineDevice &device, uint32_t threadCount, uint32_t frameCount);
+      ~EngineCommandPoolManager();
+
+      EngineCommandPoolManager(const EngineCommandPoolManager&) = delete;
+      EngineCommandPoolManager& operator=(const EngineCommandPoolManager&) = delete;
+
+      uint32_t getThreadCount() const { return this->threadCount; }
+
+      // only call after the fence of frameIndex has been waited on
+      void resetFrame(uint32_t frameIndex);
+
+      // a thread index must only be used by one thread at a time
+      std::shared_ptr<EngineCommandBuffer> acquireCommandBuffer(uint32_t threadIndex, uint32_t frameIndex, VkCommandBufferLevel level = VK_COMMAND_BUFFER_LEVEL_PRIMARY);
+
+    private:
+      struct FrameCommandPool {
+        VkCommandPool commandPool = VK_NULL_HANDLE;
+
+        std::vector<std::shared_ptr<EngineCommandBuffer>> primaryCommandBuffers;
+        std::vector<std::shared_ptr<EngineCommandBuffer>> secondaryCommandBuffers;
+
+        uint32_t usedPrimaryCount = 0;
+        uint32_t usedSecondaryCount = 0;
+      };
+
+      EngineDevice &appDevice;
+      uint32_t threadCount, frameCount;
+
+      // indexed by threadIndex * frameCount + frameIndex
+      std::vector<FrameCommandPool> framePools;
+  };
+  
+} // namespace nugiEngine
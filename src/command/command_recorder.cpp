@@ -0,0 +1,74 @@
+#include "command_recorder.hpp"
+
+#include <cassert>
+
+namespace nugiEngine {
+  EngineCommandRecorder::EngineCommandRecorder(EngineThreadPool &threadPool, EngineCommandPoolManager &commandPoolManager) 
+    : threadPool{threadPool}, commandPoolManager{commandPoolManager} 
+  {
+    assert(commandPoolManager.getThreadCount() > threadPool.getThreadCount() && "command pool manager needs a thread slot for every worker");
+  }
+
+  EngineCommandRecorder::~EngineCommandRecorder() {
+    this->threadPool.waitFor(this->runningJobCount);
+  }
+
+  void EngineCommandRecorder::beginFrame(uint32_t frameIndex) {
+    this->frameIndex = frameIndex;
+  }
+
+  EngineCommandRecorder::RecordSlot EngineCommandRecorder::addSlot() {
+    auto slot = std::make_shared<std::shared_ptr<EngineCommandBuffer>>();
+    this->recordedSlots.push_back(slot);
+
+    return slot;
+  }
+
+  void EngineCommandRecorder::recordInto(RecordSlot slot, uint32_t threadIndex, VkRenderPass renderPass, VkFramebuffer framebuffer, 
+    const std::function<void(std::shared_ptr<EngineCommandBuffer>)> &job) 
+  {
+    auto commandBuffer = this->commandPoolManager.acquireCommandBuffer(threadIndex + 1, this->frameIndex, VK_COMMAND_BUFFER_LEVEL_SECONDARY);
+
+    commandBuffer->beginSecondaryCommand(renderPass, 0, framebuffer);
+    job(commandBuffer);
+    commandBuffer->endCommand();
+
+    *slot = commandBuffer;
+  }
+
+  void EngineCommandRecorder::record(VkRenderPass renderPass, VkFramebuffer framebuffer, std::function<void(std::shared_ptr<EngineCommandBuffer>)> job) {
+    auto slot = this->addSlot();
+    this->runningJobCount.fetch_add(1);
+
+    this->threadPool.submit([this, slot, renderPass, framebuffer, job](uint32_t threadIndex) {
+      this->recordInto(slot, threadIndex, renderPass, framebuffer, job);
+
+      if (this->runningJobCount.fetch_sub(1) == 1) {
+        this->threadPool.notifyWaiters();
+      }
+    });
+  }
+
+  EngineTaskId EngineCommandRecorder::record(EngineTaskGraph &taskGraph, std::vector<EngineTaskId> dependencies, VkRenderPass renderPass, 
+    VkFramebuffer framebuffer, std::function<void(std::shared_ptr<EngineCommandBuffer>)> job) 
+  {
+    auto slot = this->addSlot();
+
+    return taskGraph.addTask([this, slot, renderPass, framebuffer, job](uint32_t threadIndex) {
+      this->recordInto(slot, threadIndex, renderPass, framebuffer, job);
+    }, dependencies);
+  }
+
+  void EngineCommandRecorder::executeCommands(std::shared_ptr<EngineCommandBuffer> primaryCommandBuffer) {
+    this->threadPool.waitFor(this->runningJobCount);
+
+    std::vector<std::shared_ptr<EngineCommandBuffer>> commandBuffers{};
+    for (auto &slot : this->recordedSlots) {
+      assert(*slot != nullptr && "a secondary command buffer was queued but never recorded");
+      commandBuffers.push_back(*slot);
+    }
+
+    primaryCommandBuffer->executeCommands(commandBuffers);
+    this->recordedSlots.clear();
+  }
+} // namespace nugiEngine
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "command_buffer.hpp"
+#include "command_pool_manager.hpp"
+#include "../thread/thread_pool.hpp"
+#include "../thread/task_graph.hpp"
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace nugiEngine
+{
+  // Records render pass contents into secondary command buffers on the thread pool. Worker i
+  // records from thread slot i + 1 of the command pool manager, so recording never takes a lock;
+  // the primary buffer then executes the secondaries in the order their jobs were queued
+  class EngineCommandRecorder {
+    public:
+      EngineCommandRecorder(EngineThreadPool &threadPool, EngineCommandPoolManager &commandPoolManager);
+      ~EngineCommandRecorder();
+
+      EngineCommandRecorder(const EngineCommandRecorder&) = delete;
+      EngineCommandRecorder& operator=(const EngineCommandRecorder&) = delete;
+
+      // the pools of frameIndex must already have been reset by the renderer
+      void beginFrame(uint32_t frameIndex);
+
+      // the job gets a secondary buffer that is already begun inside renderPass / framebuffer
+      void record(VkRenderPass renderPass, VkFramebuffer framebuffer, std::function<void(std::shared_ptr<EngineCommandBuffer>)> job);
+
+      // same, but recorded by a task of the graph once its dependencies are done
+      EngineTaskId record(EngineTaskGraph &taskGraph, std::vector<EngineTaskId> dependencies, VkRenderPass renderPass, 
+        VkFramebuffer framebuffer, std::function<void(std::shared_ptr<EngineCommandBuffer>)> job);
+
+      // waits for the jobs queued directly (graph jobs must have run already), then calls 
+      // vkCmdExecuteCommands on the primary buffer
+      void executeCommands(std::shared_ptr<EngineCommandBuffer> primaryCommandBuffer);
+
+    private:
+      typedef std::shared_ptr<std::shared_ptr<EngineCommandBuffer>> RecordSlot;
+
+      RecordSlot addSlot();
+      void recordInto(RecordSlot slot, uint32_t threadIndex, VkRenderPass renderPass, VkFramebuffer framebuffer, 
+        const std::function<void(std::shared_ptr<EngineCommandBuffer>)> &job);
+
+      EngineThreadPool &threadPool;
+      EngineCommandPoolManager &commandPoolManager;
+
+      uint32_t frameIndex = 0;
+      std::atomic<uint32_t> runningJobCount{0};
+
+      // one slot per queued job, filled by the worker that records it
+      std::vector<RecordSlot> recordedSlots;
+  };
+  
+} // namespace nugiEngine
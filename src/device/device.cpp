@@ -1,7 +1,10 @@
 #include "device.hpp"
+#include "../upload/upload_service.hpp"
 
 // std headers
+#include <cstdio>
 #include <cstring>
+#include <fstream>
 #include <iostream>
 #include <set>
 #include <unordered_set>
@@ -48,6 +51,18 @@ namespace nugiEngine {
     }
   }
 
+  // written in front of the driver's cache data, so a cache from another GPU or driver is never fed back
+  struct PipelineCachePrefix {
+    uint32_t magic;
+    uint32_t dataSize;
+    uint32_t vendorID;
+    uint32_t deviceID;
+    uint32_t driverVersion;
+    uint8_t pipelineCacheUUID[VK_UUID_SIZE];
+  };
+
+  static constexpr uint32_t PIPELINE_CACHE_MAGIC = 0x4E475043; // "NGPC"
+
   // class member functions
   EngineDevice::EngineDevice(EngineWindow &window) : window{window} {
     this->createInstance();
@@ -57,9 +72,19 @@ namespace nugiEngine {
     this->msaaSamples = this->getMaxUsableFlagsCount();
     this->createLogicalDevice();
     this->createCommandPool();
+    this->createPipelineCache();
+
+    this->memoryAllocator = std::make_unique<EngineMemoryAllocator>(this->physicalDevice, this->device);
+    this->uploadService = std::make_unique<EngineUploadService>(*this);
   }
 
   EngineDevice::~EngineDevice() {
+    this->uploadService.reset();
+    this->memoryAllocator.reset();
+
+    this->savePipelineCache();
+    vkDestroyPipelineCache(this->device, this->pipelineCache, nullptr);
+
     vkDestroyCommandPool(this->device, this->commandPool, nullptr);
     vkDestroyDevice(this->device, nullptr);
 
@@ -143,6 +168,9 @@ namespace nugiEngine {
 
     std::vector<VkDeviceQueueCreateInfo> queueCreateInfos;
     std::set<uint32_t> uniqueQueueFamilies = {indices.graphicsFamily, indices.presentFamily};
+    if (indices.transferFamilyHasValue) {
+      uniqueQueueFamilies.insert(indices.transferFamily);
+    }
 
     float queuePriority = 1.0f;
     for (uint32_t queueFamily : uniqueQueueFamilies) {
@@ -154,13 +182,40 @@ namespace nugiEngine {
       queueCreateInfos.push_back(queueCreateInfo);
     }
 
+    VkPhysicalDeviceFeatures supportedFeatures;
+    vkGetPhysicalDeviceFeatures(this->physicalDevice, &supportedFeatures);
+    this->multiDrawIndirectSupported = supportedFeatures.multiDrawIndirect == VK_TRUE;
+
     VkPhysicalDeviceFeatures deviceFeatures = {};
     deviceFeatures.samplerAnisotropy = VK_TRUE;
     deviceFeatures.sampleRateShading = VK_TRUE;
+    deviceFeatures.multiDrawIndirect = supportedFeatures.multiDrawIndirect;
+
+    // vkCmdDrawIndexedIndirectCount is core since 1.2, but still an optional feature
+    VkPhysicalDeviceVulkan12Features vulkan12Features = {};
+    vulkan12Features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+
+    if (this->properties.apiVersion >= VK_API_VERSION_1_2) {
+      VkPhysicalDeviceFeatures2 supportedFeatures2 = {};
+      supportedFeatures2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+      supportedFeatures2.pNext = &vulkan12Features;
+
+      vkGetPhysicalDeviceFeatures2(this->physicalDevice, &supportedFeatures2);
+      this->drawIndirectCountSupported = vulkan12Features.drawIndirectCount == VK_TRUE;
+
+      VkPhysicalDeviceVulkan12Features enabledVulkan12Features = {};
+      enabledVulkan12Features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+      enabledVulkan12Features.drawIndirectCount = vulkan12Features.drawIndirectCount;
+      vulkan12Features = enabledVulkan12Features;
+    }
 
     VkDeviceCreateInfo createInfo = {};
     createInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
 
+    if (this->properties.apiVersion >= VK_API_VERSION_1_2) {
+      createInfo.pNext = &vulkan12Features;
+    }
+
     createInfo.queueCreateInfoCount = static_cast<uint32_t>(queueCreateInfos.size());
     createInfo.pQueueCreateInfos = queueCreateInfos.data();
 
@@ -183,6 +238,12 @@ namespace nugiEngine {
 
     vkGetDeviceQueue(this->device, indices.graphicsFamily, 0, &this->graphicsQueue);
     vkGetDeviceQueue(this->device, indices.presentFamily, 0, &this->presentQueue);
+
+    if (indices.transferFamilyHasValue) {
+      vkGetDeviceQueue(this->device, indices.transferFamily, 0, &this->transferQueue);
+    } else {
+      this->transferQueue = this->graphicsQueue;
+    }
   }
 
   void EngineDevice::createCommandPool() {
@@ -199,6 +260,83 @@ namespace nugiEngine {
     }
   }
 
+  void EngineDevice::createPipelineCache() {
+    std::vector<char> cacheData{};
+    std::ifstream file{this->pipelineCacheFilePath, std::ios::ate | std::ios::binary};
+
+    if (file.is_open()) {
+      size_t fileSize = static_cast<size_t>(file.tellg());
+
+      if (fileSize > sizeof(PipelineCachePrefix)) {
+        PipelineCachePrefix prefix{};
+
+        file.seekg(0);
+        file.read(reinterpret_cast<char*>(&prefix), sizeof(PipelineCachePrefix));
+
+        bool isValid = prefix.magic == PIPELINE_CACHE_MAGIC 
+          && prefix.dataSize == fileSize - sizeof(PipelineCachePrefix)
+          && prefix.vendorID == this->properties.vendorID 
+          && prefix.deviceID == this->properties.deviceID
+          && prefix.driverVersion == this->properties.driverVersion
+          && std::memcmp(prefix.pipelineCacheUUID, this->properties.pipelineCacheUUID, VK_UUID_SIZE) == 0;
+
+        if (isValid) {
+          cacheData.resize(prefix.dataSize);
+          file.read(cacheData.data(), prefix.dataSize);
+        } else {
+          std::cout << "pipeline cache is stale or from another device, ignoring it" << std::endl;
+        }
+      }
+
+      file.close();
+    }
+
+    VkPipelineCacheCreateInfo cacheInfo = {};
+    cacheInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+    cacheInfo.initialDataSize = cacheData.size();
+    cacheInfo.pInitialData = cacheData.empty() ? nullptr : cacheData.data();
+
+    if (vkCreatePipelineCache(this->device, &cacheInfo, nullptr, &this->pipelineCache) != VK_SUCCESS) {
+      throw std::runtime_error("failed to create pipeline cache!");
+    }
+  }
+
+  void EngineDevice::savePipelineCache() {
+    size_t dataSize = 0;
+    if (vkGetPipelineCacheData(this->device, this->pipelineCache, &dataSize, nullptr) != VK_SUCCESS || dataSize == 0) {
+      return;
+    }
+
+    std::vector<char> cacheData(dataSize);
+    if (vkGetPipelineCacheData(this->device, this->pipelineCache, &dataSize, cacheData.data()) != VK_SUCCESS) {
+      return;
+    }
+
+    PipelineCachePrefix prefix{};
+    prefix.magic = PIPELINE_CACHE_MAGIC;
+    prefix.dataSize = static_cast<uint32_t>(dataSize);
+    prefix.vendorID = this->properties.vendorID;
+    prefix.deviceID = this->properties.deviceID;
+    prefix.driverVersion = this->properties.driverVersion;
+    std::memcpy(prefix.pipelineCacheUUID, this->properties.pipelineCacheUUID, VK_UUID_SIZE);
+
+    // write next to the old file and swap, so a crash mid-write never leaves a torn cache behind
+    std::string tempFilePath = this->pipelineCacheFilePath + ".tmp";
+    std::ofstream file{tempFilePath, std::ios::binary | std::ios::trunc};
+
+    if (!file.is_open()) {
+      std::cout << "failed to save pipeline cache" << std::endl;
+      return;
+    }
+
+    file.write(reinterpret_cast<const char*>(&prefix), sizeof(PipelineCachePrefix));
+    file.write(cacheData.data(), dataSize);
+    file.close();
+
+    std::remove(this->pipelineCacheFilePath.c_str());
+    std::rename(tempFilePath.c_str(), this->pipelineCacheFilePath.c_str());
+  }
+
   void EngineDevice::createSurface() { 
     this->window.createWindowSurface(this->instance, &this->surface); 
   }
@@ -354,6 +492,22 @@ namespace nugiEngine {
       i++;
     }
 
+    // a transfer-only family (no graphics, ideally no compute either) maps to the
+    // dedicated DMA engine on most discrete GPUs
+    for (uint32_t j = 0; j < queueFamilyCount; j++) {
+      const auto &queueFamily = queueFamilies[j];
+      if (queueFamily.queueCount == 0 || !(queueFamily.queueFlags & VK_QUEUE_TRANSFER_BIT) || 
+        (queueFamily.queueFlags & VK_QUEUE_GRAPHICS_BIT)) 
+      {
+        continue;
+      }
+
+      if (!indices.transferFamilyHasValue || !(queueFamily.queueFlags & VK_QUEUE_COMPUTE_BIT)) {
+        indices.transferFamily = j;
+        indices.transferFamilyHasValue = true;
+      }
+    }
+
     return indices;
   }
 
@@ -1,12 +1,16 @@
 #pragma once
 
 #include "../window/window.hpp"
+#include "../memory/memory_allocator.hpp"
 
 // std lib headers
+#include <memory>
 #include <string>
 #include <vector>
 
 namespace nugiEngine {
+  class EngineUploadService;
+
   struct SwapChainSupportDetails {
     VkSurfaceCapabilitiesKHR capabilities;
     std::vector<VkSurfaceFormatKHR> formats;
@@ -16,8 +20,10 @@ namespace nugiEngine {
   struct QueueFamilyIndices {
     uint32_t graphicsFamily;
     uint32_t presentFamily;
+    uint32_t transferFamily;
     bool graphicsFamilyHasValue = false;
     bool presentFamilyHasValue = false;
+    bool transferFamilyHasValue = false;
     bool isComplete() { return graphicsFamilyHasValue && presentFamilyHasValue; }
   };
 
@@ -41,11 +47,19 @@ namespace nugiEngine {
       VkDevice getLogicalDevice() { return this->device; }
       VkPhysicalDevice getPhysicalDevice() { return this->physicalDevice; }
       VkCommandPool getCommandPool() { return this->commandPool; }
+      VkPipelineCache getPipelineCache() { return this->pipelineCache; }
       VkSurfaceKHR getSurface() { return this->surface; }
       VkQueue getGraphicsQueue() { return this->graphicsQueue; }
       VkQueue getPresentQueue() { return this->presentQueue; }
+      VkQueue getTransferQueue() { return this->transferQueue; }
       VkPhysicalDeviceProperties getProperties() { return this->properties; }
       VkSampleCountFlagBits getMSAASamples() { return this->msaaSamples; }
+      EngineMemoryAllocator* getMemoryAllocator() { return this->memoryAllocator.get(); }
+      EngineUploadService* getUploadService() { return this->uploadService.get(); }
+
+      // optional indirect drawing features, the renderer falls back when they are missing
+      bool isMultiDrawIndirectSupported() { return this->multiDrawIndirectSupported; }
+      bool isDrawIndirectCountSupported() { return this->drawIndirectCountSupported; }
 
       SwapChainSupportDetails getSwapChainSupport() { return this->querySwapChainSupport(this->physicalDevice); }
       QueueFamilyIndices findPhysicalQueueFamilies() { return this->findQueueFamilies(this->physicalDevice); }
@@ -60,6 +74,8 @@ namespace nugiEngine {
       void pickPhysicalDevice();
       void createLogicalDevice();
       void createCommandPool();
+      void createPipelineCache();
+      void savePipelineCache();
 
       // helper creation functions
       bool isDeviceSuitable(VkPhysicalDevice device);
@@ -89,10 +105,25 @@ namespace nugiEngine {
       VkCommandPool commandPool;
       VkQueue graphicsQueue;
       VkQueue presentQueue;
+      VkQueue transferQueue;
+
+      // shared by every pipeline, persisted in pipelineCacheFilePath between runs
+      VkPipelineCache pipelineCache = VK_NULL_HANDLE;
+
+      // sub-allocator for every buffer & image memory
+      std::unique_ptr<EngineMemoryAllocator> memoryAllocator;
+
+      // staging & copy of meshes and textures, on the transfer queue if there is one
+      std::unique_ptr<EngineUploadService> uploadService;
 
       // Anti-aliasing
       VkSampleCountFlagBits msaaSamples = VK_SAMPLE_COUNT_1_BIT;
 
+      // indirect drawing
+      bool multiDrawIndirectSupported = false;
+      bool drawIndirectCountSupported = false;
+
+      const std::string pipelineCacheFilePath = "pipeline_cache.bin";
       const std::vector<const char *> validationLayers = {"VK_LAYER_KHRONOS_validation"};
       const std::vector<const char *> deviceExtensions = {VK_KHR_SWAPCHAIN_EXTENSION_NAME};
   };
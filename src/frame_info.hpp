@@ -1,6 +1,7 @@
 #pragma once
 
 #include "camera/camera.hpp"
+#include "buffer/frame_allocator.hpp"
 
 #include <vulkan/vulkan.h>
 
@@ -9,6 +10,15 @@ namespace nugiEngine {
     int frameIndex;
     float frameTime;
     EngineCamera &camera;
+
+    // dynamic offsets of this frame's GlobalUBO & GlobalLight in the frame allocator, and of its
+    // LightClusterData in the renderer's cluster buffer
+    uint32_t globalUboOffset = 0;
+    uint32_t globalLightOffset = 0;
+    uint32_t lightClusterOffset = 0;
+
+    // transient per-frame storage, e.g. the instance data of the render systems
+    EngineFrameAllocator *frameAllocator = nullptr;
   };
   
 } // namespace nugiEngine
@@ -1,7 +1,28 @@
 #include "game_object.hpp"
 
 namespace nugiEngine {
-  glm::mat4 TransformComponent::mat4() {
+  const glm::mat4& TransformComponent::mat4() {
+    this->updateMatrices();
+    return this->cachedMatrix;
+  }
+
+  const glm::mat3& TransformComponent::normalMatrix() {
+    this->updateMatrices();
+    return this->cachedNormalMatrix;
+  }
+
+  void TransformComponent::updateMatrices() {
+    bool isRotationScaleClean = this->isCached && this->rotation == this->cachedRotation && this->scale == this->cachedScale;
+
+    if (isRotationScaleClean) {
+      if (this->translation != this->cachedTranslation) {
+        this->cachedMatrix[3] = glm::vec4{this->translation, 1.0f};
+        this->cachedTranslation = this->translation;
+      }
+
+      return;
+    }
+
     const float c3 = glm::cos(this->rotation.z);
     const float s3 = glm::sin(this->rotation.z);
     const float c2 = glm::cos(this->rotation.x);
@@ -9,7 +30,7 @@ namespace nugiEngine {
     const float c1 = glm::cos(this->rotation.y);
     const float s1 = glm::sin(this->rotation.y);
     
-    return glm::mat4{
+    this->cachedMatrix = glm::mat4{
       {
         this->scale.x * (c1 * c3 + s1 * s2 * s3),
         this->scale.x * (c2 * s3),
@@ -30,19 +51,10 @@ namespace nugiEngine {
       },
       {this->translation.x, this->translation.y, this->translation.z, 1.0f}
     };
-  }
-
-  glm::mat3 TransformComponent::normalMatrix() {
-    const float c3 = glm::cos(this->rotation.z);
-    const float s3 = glm::sin(this->rotation.z);
-    const float c2 = glm::cos(this->rotation.x);
-    const float s2 = glm::sin(this->rotation.x);
-    const float c1 = glm::cos(this->rotation.y);
-    const float s1 = glm::sin(this->rotation.y);
 
     const glm::vec3 invScale = 1.0f / scale;
     
-    return glm::mat3{
+    this->cachedNormalMatrix = glm::mat3{
       {
         invScale.x * (c1 * c3 + s1 * s2 * s3),
         invScale.x * (c2 * s3),
@@ -59,28 +71,11 @@ namespace nugiEngine {
         invScale.z * (c1 * c2)
       },
     };
-  }
-
-  EngineGameObject EngineGameObject::createPointLight(float intensity, float radius, glm::vec3 color) {
-    EngineGameObject gameObject = EngineGameObject::createGameObject();
-    gameObject.color =  color;
-    gameObject.transform.scale.x = radius;
-    
-    gameObject.pointLights = std::make_unique<PointLightComponent>();
-    gameObject.pointLights->lightIntensity = intensity;
-
-    return gameObject;
-  }
-
-  std::shared_ptr<EngineGameObject> EngineGameObject::createSharedPointLight(float intensity, float radius, glm::vec3 color) {
-    std::shared_ptr<EngineGameObject> gameObject = EngineGameObject::createSharedGameObject();
-    gameObject->color =  color;
-    gameObject->transform.scale.x = radius;
-    
-    gameObject->pointLights = std::make_unique<PointLightComponent>();
-    gameObject->pointLights->lightIntensity = intensity;
 
-    return gameObject;
+    this->cachedTranslation = this->translation;
+    this->cachedRotation = this->rotation;
+    this->cachedScale = this->scale;
+    this->isCached = true;
   }
   
 } // namespace nugiEngine
@@ -12,14 +12,22 @@ namespace nugiEngine {
 		glm::vec3 scale{1.0f, 1.0f, 1.0f};
 		glm::vec3 rotation{};
 
-		glm::mat4 mat4();
-		glm::mat3 normalMatrix();
-	};
+		// cached, only rebuilt when translation, rotation or scale differ from what they were built from;
+		// a pure translation change just rewrites the last column
+		const glm::mat4& mat4();
+		const glm::mat3& normalMatrix();
+
+	private:
+		void updateMatrices();
 
-	struct PointLightComponent {
-		float lightIntensity = 1.0f;
+		glm::vec3 cachedTranslation{};
+		glm::vec3 cachedScale{};
+		glm::vec3 cachedRotation{};
+
+		glm::mat4 cachedMatrix{1.0f};
+		glm::mat3 cachedNormalMatrix{1.0f};
+		bool isCached = false;
 	};
-	
 
 	class EngineGameObject
 	{
@@ -36,9 +44,6 @@ namespace nugiEngine {
 			return std::make_shared<EngineGameObject>(currentId++);
 		}
 
-		static EngineGameObject createPointLight(float intensity = 10.0f, float radius = 1.0f, glm::vec3 color = glm::vec3{1.0f});
-		static std::shared_ptr<EngineGameObject> createSharedPointLight(float intensity = 10.0f, float radius = 1.0f, glm::vec3 color = glm::vec3{1.0f});
-
 		EngineGameObject(const EngineGameObject &) = delete;
 		EngineGameObject& operator = (const EngineGameObject &) = delete;
 		EngineGameObject(EngineGameObject &&) = default;
@@ -51,10 +56,6 @@ namespace nugiEngine {
 		TransformComponent transform{};
 		glm::vec3 color{};
 
-		std::shared_ptr<EngineModel> model{};
-		std::shared_ptr<EngineTexture> texture{};
-		std::shared_ptr<VkDescriptorSet> textureDescSet{};
-		std::unique_ptr<PointLightComponent> pointLights = nullptr;
 	private:
 		id_t objectId;
 	};
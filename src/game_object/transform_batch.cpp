@@ -0,0 +1,234 @@
+#include "transform_batch.hpp"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+  #include <emmintrin.h>
+  #define NUGI_TRANSFORM_SSE2
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+  #include <arm_neon.h>
+  #define NUGI_TRANSFORM_NEON
+#endif
+
+namespace nugiEngine {
+  void computeTransformMatricesScalar(const EngineTransformStreams &streams, size_t begin, size_t end, glm::mat4 *modelMatrices, glm::mat4 *normalMatrices) {
+    for (size_t i = begin; i < end; i++) {
+      const float c3 = glm::cos(streams.rotationZ[i]);
+      const float s3 = glm::sin(streams.rotationZ[i]);
+      const float c2 = glm::cos(streams.rotationX[i]);
+      const float s2 = glm::sin(streams.rotationX[i]);
+      const float c1 = glm::cos(streams.rotationY[i]);
+      const float s1 = glm::sin(streams.rotationY[i]);
+
+      const glm::vec3 axisX{c1 * c3 + s1 * s2 * s3, c2 * s3, c1 * s2 * s3 - c3 * s1};
+      const glm::vec3 axisY{c3 * s1 * s2 - c1 * s3, c2 * c3, c1 * c3 * s2 + s1 * s3};
+      const glm::vec3 axisZ{c2 * s1, -s2, c1 * c2};
+
+      if (modelMatrices != nullptr) {
+        modelMatrices[i] = glm::mat4{
+          glm::vec4{streams.scaleX[i] * axisX, 0.0f},
+          glm::vec4{streams.scaleY[i] * axisY, 0.0f},
+          glm::vec4{streams.scaleZ[i] * axisZ, 0.0f},
+          glm::vec4{streams.translationX[i], streams.translationY[i], streams.translationZ[i], 1.0f}
+        };
+      }
+
+      if (normalMatrices != nullptr) {
+        normalMatrices[i] = glm::mat4{
+          glm::vec4{axisX / streams.scaleX[i], 0.0f},
+          glm::vec4{axisY / streams.scaleY[i], 0.0f},
+          glm::vec4{axisZ / streams.scaleZ[i], 0.0f},
+          glm::vec4{0.0f, 0.0f, 0.0f, 1.0f}
+        };
+      }
+    }
+  }
+
+#if defined(NUGI_TRANSFORM_SSE2) || defined(NUGI_TRANSFORM_NEON)
+  // Cody-Waite reduction to [-pi/4, pi/4] plus the cephes single precision polynomials
+  static constexpr float TWO_OVER_PI = 0.636619772367581f;
+  static constexpr float HALF_PI_PART1 = 1.5703125f;
+  static constexpr float HALF_PI_PART2 = 4.837512969970703125e-4f;
+  static constexpr float HALF_PI_PART3 = 7.54978995489188216e-8f;
+
+  static constexpr float SIN_COEF1 = -1.6666654611e-1f;
+  static constexpr float SIN_COEF2 = 8.3321608736e-3f;
+  static constexpr float SIN_COEF3 = -1.9515295891e-4f;
+
+  static constexpr float COS_COEF1 = 4.166664568298827e-2f;
+  static constexpr float COS_COEF2 = -1.388731625493765e-3f;
+  static constexpr float COS_COEF3 = 2.443315711809948e-5f;
+#endif
+
+#if defined(NUGI_TRANSFORM_SSE2)
+  typedef __m128 float4;
+
+  static inline float4 load4(const float *p) { return _mm_loadu_ps(p); }
+  static inline float4 set4(float v) { return _mm_set1_ps(v); }
+  static inline float4 add4(float4 a, float4 b) { return _mm_add_ps(a, b); }
+  static inline float4 sub4(float4 a, float4 b) { return _mm_sub_ps(a, b); }
+  static inline float4 mul4(float4 a, float4 b) { return _mm_mul_ps(a, b); }
+  static inline float4 div4(float4 a, float4 b) { return _mm_div_ps(a, b); }
+  static inline void store4(float *p, float4 v) { _mm_storeu_ps(p, v); }
+
+  static inline void transpose4(float4 &r0, float4 &r1, float4 &r2, float4 &r3) {
+    _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+  }
+
+  static inline void sinCos4(float4 x, float4 &sine, float4 &cosine) {
+    __m128i quadrant = _mm_cvtps_epi32(_mm_mul_ps(x, _mm_set1_ps(TWO_OVER_PI)));
+    __m128 q = _mm_cvtepi32_ps(quadrant);
+
+    __m128 r = _mm_sub_ps(x, _mm_mul_ps(q, _mm_set1_ps(HALF_PI_PART1)));
+    r = _mm_sub_ps(r, _mm_mul_ps(q, _mm_set1_ps(HALF_PI_PART2)));
+    r = _mm_sub_ps(r, _mm_mul_ps(q, _mm_set1_ps(HALF_PI_PART3)));
+    __m128 z = _mm_mul_ps(r, r);
+
+    __m128 sinR = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(SIN_COEF3), z), _mm_set1_ps(SIN_COEF2));
+    sinR = _mm_add_ps(_mm_mul_ps(sinR, z), _mm_set1_ps(SIN_COEF1));
+    sinR = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(sinR, z), r), r);
+
+    __m128 cosR = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(COS_COEF3), z), _mm_set1_ps(COS_COEF2));
+    cosR = _mm_add_ps(_mm_mul_ps(cosR, z), _mm_set1_ps(COS_COEF1));
+    cosR = _mm_mul_ps(_mm_mul_ps(cosR, z), z);
+    cosR = _mm_add_ps(_mm_sub_ps(cosR, _mm_mul_ps(_mm_set1_ps(0.5f), z)), _mm_set1_ps(1.0f));
+
+    // odd quadrants swap sin & cos, bit 1 of the quadrant flips the sign
+    __m128i one = _mm_set1_epi32(1);
+    __m128i two = _mm_set1_epi32(2);
+    __m128 swap = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(quadrant, one), one));
+
+    __m128 sinSign = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(quadrant, two), 30));
+    __m128 cosSign = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(_mm_add_epi32(quadrant, one), two), 30));
+
+    sine = _mm_or_ps(_mm_and_ps(swap, cosR), _mm_andnot_ps(swap, sinR));
+    cosine = _mm_or_ps(_mm_and_ps(swap, sinR), _mm_andnot_ps(swap, cosR));
+
+    sine = _mm_xor_ps(sine, sinSign);
+    cosine = _mm_xor_ps(cosine, cosSign);
+  }
+#elif defined(NUGI_TRANSFORM_NEON)
+  typedef float32x4_t float4;
+
+  static inline float4 load4(const float *p) { return vld1q_f32(p); }
+  static inline float4 set4(float v) { return vdupq_n_f32(v); }
+  static inline float4 add4(float4 a, float4 b) { return vaddq_f32(a, b); }
+  static inline float4 sub4(float4 a, float4 b) { return vsubq_f32(a, b); }
+  static inline float4 mul4(float4 a, float4 b) { return vmulq_f32(a, b); }
+  static inline float4 div4(float4 a, float4 b) { return vdivq_f32(a, b); }
+  static inline void store4(float *p, float4 v) { vst1q_f32(p, v); }
+
+  static inline void transpose4(float4 &r0, float4 &r1, float4 &r2, float4 &r3) {
+    float32x4x2_t t01 = vtrnq_f32(r0, r1);
+    float32x4x2_t t23 = vtrnq_f32(r2, r3);
+
+    r0 = vcombine_f32(vget_low_f32(t01.val[0]), vget_low_f32(t23.val[0]));
+    r1 = vcombine_f32(vget_low_f32(t01.val[1]), vget_low_f32(t23.val[1]));
+    r2 = vcombine_f32(vget_high_f32(t01.val[0]), vget_high_f32(t23.val[0]));
+    r3 = vcombine_f32(vget_high_f32(t01.val[1]), vget_high_f32(t23.val[1]));
+  }
+
+  static inline void sinCos4(float4 x, float4 &sine, float4 &cosine) {
+    int32x4_t quadrant = vcvtnq_s32_f32(vmulq_n_f32(x, TWO_OVER_PI));
+    float32x4_t q = vcvtq_f32_s32(quadrant);
+
+    float32x4_t r = vmlsq_n_f32(x, q, HALF_PI_PART1);
+    r = vmlsq_n_f32(r, q, HALF_PI_PART2);
+    r = vmlsq_n_f32(r, q, HALF_PI_PART3);
+    float32x4_t z = vmulq_f32(r, r);
+
+    float32x4_t sinR = vmlaq_n_f32(vdupq_n_f32(SIN_COEF2), z, SIN_COEF3);
+    sinR = vmlaq_f32(vdupq_n_f32(SIN_COEF1), sinR, z);
+    sinR = vmlaq_f32(r, vmulq_f32(sinR, z), r);
+
+    float32x4_t cosR = vmlaq_n_f32(vdupq_n_f32(COS_COEF2), z, COS_COEF3);
+    cosR = vmlaq_f32(vdupq_n_f32(COS_COEF1), cosR, z);
+    cosR = vmulq_f32(vmulq_f32(cosR, z), z);
+    cosR = vaddq_f32(vmlsq_n_f32(cosR, z, 0.5f), vdupq_n_f32(1.0f));
+
+    // odd quadrants swap sin & cos, bit 1 of the quadrant flips the sign
+    int32x4_t one = vdupq_n_s32(1);
+    int32x4_t two = vdupq_n_s32(2);
+    uint32x4_t swap = vceqq_s32(vandq_s32(quadrant, one), one);
+
+    uint32x4_t sinSign = vreinterpretq_u32_s32(vshlq_n_s32(vandq_s32(quadrant, two), 30));
+    uint32x4_t cosSign = vreinterpretq_u32_s32(vshlq_n_s32(vandq_s32(vaddq_s32(quadrant, one), two), 30));
+
+    sine = vbslq_f32(swap, cosR, sinR);
+    cosine = vbslq_f32(swap, sinR, cosR);
+
+    sine = vreinterpretq_f32_u32(veorq_u32(vreinterpretq_u32_f32(sine), sinSign));
+    cosine = vreinterpretq_f32_u32(veorq_u32(vreinterpretq_u32_f32(cosine), cosSign));
+  }
+#endif
+
+#if defined(NUGI_TRANSFORM_SSE2) || defined(NUGI_TRANSFORM_NEON)
+  // r0..r3 hold one matrix column for four objects, one row each; transposed they are four columns
+  static inline void storeColumn(glm::mat4 *matrices, size_t first, int column, float4 r0, float4 r1, float4 r2, float4 r3) {
+    transpose4(r0, r1, r2, r3);
+
+    store4(&matrices[first + 0][column][0], r0);
+    store4(&matrices[first + 1][column][0], r1);
+    store4(&matrices[first + 2][column][0], r2);
+    store4(&matrices[first + 3][column][0], r3);
+  }
+
+  static void computeTransformBlock(const EngineTransformStreams &streams, size_t i, glm::mat4 *modelMatrices, glm::mat4 *normalMatrices) {
+    float4 s1, c1, s2, c2, s3, c3;
+    sinCos4(load4(streams.rotationY + i), s1, c1);
+    sinCos4(load4(streams.rotationX + i), s2, c2);
+    sinCos4(load4(streams.rotationZ + i), s3, c3);
+
+    float4 s2s3 = mul4(s2, s3);
+    float4 c3s2 = mul4(c3, s2);
+
+    float4 x0 = add4(mul4(c1, c3), mul4(s1, s2s3));
+    float4 x1 = mul4(c2, s3);
+    float4 x2 = sub4(mul4(c1, s2s3), mul4(c3, s1));
+
+    float4 y0 = sub4(mul4(c3s2, s1), mul4(c1, s3));
+    float4 y1 = mul4(c2, c3);
+    float4 y2 = add4(mul4(c1, c3s2), mul4(s1, s3));
+
+    float4 z0 = mul4(c2, s1);
+    float4 z1 = sub4(set4(0.0f), s2);
+    float4 z2 = mul4(c1, c2);
+
+    float4 scaleX = load4(streams.scaleX + i);
+    float4 scaleY = load4(streams.scaleY + i);
+    float4 scaleZ = load4(streams.scaleZ + i);
+
+    float4 zero = set4(0.0f);
+    float4 one = set4(1.0f);
+
+    if (modelMatrices != nullptr) {
+      storeColumn(modelMatrices, i, 0, mul4(scaleX, x0), mul4(scaleX, x1), mul4(scaleX, x2), zero);
+      storeColumn(modelMatrices, i, 1, mul4(scaleY, y0), mul4(scaleY, y1), mul4(scaleY, y2), zero);
+      storeColumn(modelMatrices, i, 2, mul4(scaleZ, z0), mul4(scaleZ, z1), mul4(scaleZ, z2), zero);
+      storeColumn(modelMatrices, i, 3, load4(streams.translationX + i), load4(streams.translationY + i), load4(streams.translationZ + i), one);
+    }
+
+    if (normalMatrices != nullptr) {
+      float4 invScaleX = div4(one, scaleX);
+      float4 invScaleY = div4(one, scaleY);
+      float4 invScaleZ = div4(one, scaleZ);
+
+      storeColumn(normalMatrices, i, 0, mul4(invScaleX, x0), mul4(invScaleX, x1), mul4(invScaleX, x2), zero);
+      storeColumn(normalMatrices, i, 1, mul4(invScaleY, y0), mul4(invScaleY, y1), mul4(invScaleY, y2), zero);
+      storeColumn(normalMatrices, i, 2, mul4(invScaleZ, z0), mul4(invScaleZ, z1), mul4(invScaleZ, z2), zero);
+      storeColumn(normalMatrices, i, 3, zero, zero, zero, one);
+    }
+  }
+#endif
+
+  void computeTransformMatrices(const EngineTransformStreams &streams, size_t count, glm::mat4 *modelMatrices, glm::mat4 *normalMatrices) {
+    size_t i = 0;
+
+#if defined(NUGI_TRANSFORM_SSE2) || defined(NUGI_TRANSFORM_NEON)
+    for (; i + 4 <= count; i += 4) {
+      computeTransformBlock(streams, i, modelMatrices, normalMatrices);
+    }
+#endif
+
+    computeTransformMatricesScalar(streams, i, count, modelMatrices, normalMatrices);
+  }
+  
+} // namespace nugiEngine
@@ -0,0 +1,29 @@
+#pragma once
+
+#define GLM_FORCE_RADIANS
+#define GLM_FORCE_DEPTH_ZERO_TO_ONE
+#include <glm/glm.hpp>
+
+#include <cstddef>
+
+namespace nugiEngine {
+  // Translation, rotation (euler, Y * X * Z like TransformComponent) and scale of many objects,
+  // one array per component
+  struct EngineTransformStreams {
+    const float *translationX, *translationY, *translationZ;
+    const float *rotationX, *rotationY, *rotationZ;
+    const float *scaleX, *scaleY, *scaleZ;
+  };
+
+  /**
+   * Builds the same model & normal matrices as TransformComponent for count objects. Four objects
+   * go through the SSE2 / NEON kernel at a time, with its own sin/cos polynomial; the remainder
+   * and targets without either use the scalar path. Normal matrices are written as a mat4 with
+   * the 3x3 part in the upper left, the way the instance data wants them. Either output may be null.
+   */
+  void computeTransformMatrices(const EngineTransformStreams &streams, size_t count, glm::mat4 *modelMatrices, glm::mat4 *normalMatrices);
+
+  // the scalar path only, for comparing against the kernel
+  void computeTransformMatricesScalar(const EngineTransformStreams &streams, size_t begin, size_t end, glm::mat4 *modelMatrices, glm::mat4 *normalMatrices);
+  
+} // namespace nugiEngine
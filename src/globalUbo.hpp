@@ -5,11 +5,12 @@
 #include <glm/glm.hpp>
 #include <glm/gtc/constants.hpp>
 
-namespace nugiEngine {
-  #define MAX_LIGHTS 10
+// cluster grid & per cluster light limit, the same file is included by the shaders
+#include "shader/light_cluster_config.h"
 
+namespace nugiEngine {
   struct pointLight {
-    glm::vec4 position{};
+    glm::vec4 position{}; // w: range, the light has no effect past it
     glm::vec4 color{};
   };
 
@@ -19,9 +20,26 @@ namespace nugiEngine {
     glm::mat4 inverseView{1.0f};
   };
 
+  // header of the light storage buffer, numLights pointLight follow it (std430)
   struct GlobalLight {
     glm::vec4 ambientLightColor{1.0f, 1.0f, 1.0f, 0.02f};
-    pointLight pointLights[MAX_LIGHTS];
-    int numLights;
+    glm::vec4 clusterParams{0.0f}; // tile width & height in pixels, depth slice scale & bias
+    uint32_t numLights = 0;
+    uint32_t padding[3];
+  };
+
+  // range of the light storage buffer descriptors, the header and MAX_LIGHTS lights
+  constexpr size_t LIGHT_BUFFER_RANGE = sizeof(GlobalLight) + sizeof(pointLight) * MAX_LIGHTS;
+
+  // std430, the light indices of a cluster start at clusterIndex * MAX_LIGHTS_PER_CLUSTER
+  struct LightClusterData {
+    uint32_t lightCounts[CLUSTER_COUNT];
+    uint32_t lightIndices[CLUSTER_COUNT * MAX_LIGHTS_PER_CLUSTER];
+  };
+
+  // std430, written by the cluster pass when a cluster is reached by more than MAX_LIGHTS_PER_CLUSTER lights
+  struct LightClusterOverflow {
+    uint32_t clusterCount = 0;
+    uint32_t maxLightCount = 0; // most lights reaching a single cluster
   };
-}
\ No newline at end of file
+}
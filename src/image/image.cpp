@@ -24,7 +24,7 @@ namespace nugiEngine {
 
     if (this->isImageCreatedByUs) {
       vkDestroyImage(this->appDevice.getLogicalDevice(), this->image, nullptr);
-      vkFreeMemory(this->appDevice.getLogicalDevice(), this->imageMemory, nullptr);
+      this->appDevice.getMemoryAllocator()->free(this->imageMemory);
     }
   }
 
@@ -51,16 +51,10 @@ namespace nugiEngine {
     VkMemoryRequirements memRequirements;
     vkGetImageMemoryRequirements(this->appDevice.getLogicalDevice(), this->image, &memRequirements);
 
-    VkMemoryAllocateInfo allocInfo{};
-    allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-    allocInfo.allocationSize = memRequirements.size;
-    allocInfo.memoryTypeIndex = this->appDevice.findMemoryType(memRequirements.memoryTypeBits, properties);
+    auto resourceKind = (tiling == VK_IMAGE_TILING_OPTIMAL) ? EngineMemoryResourceKind::Optimal : EngineMemoryResourceKind::Linear;
+    this->imageMemory = this->appDevice.getMemoryAllocator()->allocate(memRequirements, properties, resourceKind);
 
-    if (vkAllocateMemory(this->appDevice.getLogicalDevice(), &allocInfo, nullptr, &this->imageMemory) != VK_SUCCESS) {
-      throw std::runtime_error("failed to allocate image memory!");
-    }
-
-    if (vkBindImageMemory(this->appDevice.getLogicalDevice(), this->image, this->imageMemory, 0) != VK_SUCCESS) {
+    if (vkBindImageMemory(this->appDevice.getLogicalDevice(), this->image, this->imageMemory.memory, this->imageMemory.offset) != VK_SUCCESS) {
       throw std::runtime_error("failed to bind image memory!");
     }
   }
@@ -86,10 +80,7 @@ namespace nugiEngine {
     }
   }
 
-  void EngineImage::transitionImageLayout(VkImageLayout oldLayout, VkImageLayout newLayout) {
-    EngineCommandBuffer commandBuffer{this->appDevice};
-    commandBuffer.beginSingleTimeCommand();
-
+  void EngineImage::transitionImageLayout(VkCommandBuffer commandBuffer, VkImageLayout oldLayout, VkImageLayout newLayout) {
     VkImageMemoryBarrier barrier{};
     barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
     barrier.oldLayout = oldLayout;
@@ -137,7 +128,7 @@ namespace nugiEngine {
     }
 
     vkCmdPipelineBarrier(
-      commandBuffer.getCommandBuffer(), 
+      commandBuffer, 
       sourceStage, 
       destinationStage,
       0,
@@ -146,12 +137,9 @@ namespace nugiEngine {
       1, 
       &barrier
     );
-
-    commandBuffer.endCommand();
-    commandBuffer.submitCommand(this->appDevice.getGraphicsQueue());
   }
 
-  void EngineImage::generateMipMap() {
+  void EngineImage::generateMipMap(VkCommandBuffer commandBuffer) {
     if (!this->isImageCreatedByUs) {
       throw std::runtime_error("cannot generate mipmap if the image is not created by this class => image directly assigned to this class via second constructor");
     }
@@ -164,9 +152,6 @@ namespace nugiEngine {
       throw std::runtime_error("texture image format does not support linear blitting!");
     }
 
-    EngineCommandBuffer commandBuffer{this->appDevice};
-    commandBuffer.beginSingleTimeCommand();
-
     VkImageMemoryBarrier barrier{};
     barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
     barrier.image = this->image;
@@ -188,7 +173,7 @@ namespace nugiEngine {
       barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
 
       vkCmdPipelineBarrier(
-        commandBuffer.getCommandBuffer(),
+        commandBuffer,
         VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0,
         0, nullptr,
         0, nullptr,
@@ -211,7 +196,7 @@ namespace nugiEngine {
       blit.dstSubresource.layerCount = 1;
 
       vkCmdBlitImage(
-        commandBuffer.getCommandBuffer(),
+        commandBuffer,
         this->image, 
         VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
         this->image, 
@@ -227,7 +212,7 @@ namespace nugiEngine {
       barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
 
       vkCmdPipelineBarrier(
-        commandBuffer.getCommandBuffer(),
+        commandBuffer,
         VK_PIPELINE_STAGE_TRANSFER_BIT, 
         VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 
         0,
@@ -248,15 +233,12 @@ namespace nugiEngine {
     barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
 
     vkCmdPipelineBarrier(
-      commandBuffer.getCommandBuffer(),
+      commandBuffer,
       VK_PIPELINE_STAGE_TRANSFER_BIT, 
       VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0,
       0, nullptr,
       0, nullptr,
       1, &barrier);
-
-    commandBuffer.endCommand();
-    commandBuffer.submitCommand(this->appDevice.getGraphicsQueue());
   }
   
 } // namespace nugiEngine
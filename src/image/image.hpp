@@ -19,17 +19,22 @@ namespace nugiEngine
 
       VkImage getImage() const { return this->image; }
       VkImageView getImageView() const { return this->imageView; }
-      VkDeviceMemory getImageMemory() const { return this->imageMemory; }
+      VkDeviceMemory getImageMemory() const { return this->imageMemory.memory; }
+      VkImageAspectFlags getAspectFlags() const { return this->aspectFlags; }
+      uint32_t getWidth() const { return this->width; }
+      uint32_t getHeight() const { return this->height; }
+      uint32_t getMipLevels() const { return this->mipLevels; }
 
-      void transitionImageLayout(VkImageLayout oldLayout, VkImageLayout newLayout);
-      void generateMipMap();
+      // recorded into a command buffer owned by the caller, see EngineUploadService
+      void transitionImageLayout(VkCommandBuffer commandBuffer, VkImageLayout oldLayout, VkImageLayout newLayout);
+      void generateMipMap(VkCommandBuffer commandBuffer);
 
     private:
       EngineDevice &appDevice;
 
       VkImage image;
       VkImageView imageView;
-      VkDeviceMemory imageMemory;
+      EngineMemoryAllocation imageMemory;
       VkFormat format;
       VkImageAspectFlags aspectFlags;
       
@@ -0,0 +1,336 @@
+#include "memory_allocator.hpp"
+
+// std headers
+#include <algorithm>
+#include <cassert>
+#include <iomanip>
+#include <iostream>
+#include <stdexcept>
+
+namespace nugiEngine {
+  static VkDeviceSize alignUp(VkDeviceSize value, VkDeviceSize alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+  }
+
+  static VkDeviceSize alignDown(VkDeviceSize value, VkDeviceSize alignment) {
+    return value / alignment * alignment;
+  }
+
+  float EngineMemoryHeapStats::fragmentation() const {
+    VkDeviceSize freeSize = this->reservedSize - this->usedSize;
+    if (freeSize == 0) return 0.0f;
+
+    return 1.0f - static_cast<float>(this->largestFreeRange) / static_cast<float>(freeSize);
+  }
+
+  EngineMemoryAllocator::EngineMemoryAllocator(VkPhysicalDevice physicalDevice, VkDevice device) : device{device} {
+    vkGetPhysicalDeviceMemoryProperties(physicalDevice, &this->memoryProperties);
+
+    VkPhysicalDeviceProperties properties;
+    vkGetPhysicalDeviceProperties(physicalDevice, &properties);
+
+    this->bufferImageGranularity = std::max<VkDeviceSize>(properties.limits.bufferImageGranularity, 1);
+    this->nonCoherentAtomSize = std::max<VkDeviceSize>(properties.limits.nonCoherentAtomSize, 1);
+
+    this->dedicatedSizes.resize(this->memoryProperties.memoryHeapCount, 0);
+    this->dedicatedCounts.resize(this->memoryProperties.memoryHeapCount, 0);
+  }
+
+  EngineMemoryAllocator::~EngineMemoryAllocator() {
+    for (auto &&block : this->blocks) {
+      if (!block->ranges->isEmpty()) {
+        std::cerr << "memory allocator: block of memory type " << block->memoryTypeIndex << " still has "
+          << block->ranges->getAllocationCount() << " live allocations on destroy" << std::endl;
+      }
+
+      if (block->mapped != nullptr) {
+        vkUnmapMemory(this->device, block->memory);
+      }
+
+      vkFreeMemory(this->device, block->memory, nullptr);
+    }
+  }
+
+  EngineMemoryAllocation EngineMemoryAllocator::allocate(VkMemoryRequirements requirements, VkMemoryPropertyFlags properties, EngineMemoryResourceKind kind) {
+    std::lock_guard<std::mutex> lock{this->mutex};
+
+    uint32_t memoryTypeIndex = this->findMemoryType(requirements.memoryTypeBits, properties);
+    VkDeviceSize size = requirements.size;
+    VkDeviceSize alignment = std::max<VkDeviceSize>(requirements.alignment, 1);
+
+    // flush and invalidate work on whole atoms, so two allocations must never share one
+    if (this->isHostVisible(memoryTypeIndex) && !this->isHostCoherent(memoryTypeIndex)) {
+      alignment = std::max(alignment, this->nonCoherentAtomSize);
+      size = alignUp(size, this->nonCoherentAtomSize);
+    }
+
+    // without a granularity restriction, buffers and images can live in the same block
+    if (this->bufferImageGranularity == 1) {
+      kind = EngineMemoryResourceKind::Linear;
+    }
+
+    VkDeviceSize blockSize = this->getBlockSize(memoryTypeIndex);
+    if (size > blockSize / 2) {
+      return this->allocateDedicated(memoryTypeIndex, size);
+    }
+
+    EngineMemoryBlock* targetBlock = nullptr;
+    VkDeviceSize offset = EngineRangeAllocator::invalidOffset;
+
+    for (auto &&block : this->blocks) {
+      if (block->memoryTypeIndex != memoryTypeIndex || block->kind != kind) continue;
+
+      offset = block->ranges->allocate(size, alignment);
+      if (offset != EngineRangeAllocator::invalidOffset) {
+        targetBlock = block.get();
+        break;
+      }
+    }
+
+    if (targetBlock == nullptr) {
+      targetBlock = this->createBlock(memoryTypeIndex, kind, blockSize);
+      offset = targetBlock->ranges->allocate(size, alignment);
+    }
+
+    EngineMemoryAllocation allocation{};
+    allocation.memory = targetBlock->memory;
+    allocation.offset = offset;
+    allocation.size = size;
+    allocation.memoryTypeIndex = memoryTypeIndex;
+    allocation.block = targetBlock;
+
+    if (targetBlock->mapped != nullptr) {
+      allocation.mapped = static_cast<char*>(targetBlock->mapped) + offset;
+    }
+
+    return allocation;
+  }
+
+  void EngineMemoryAllocator::free(EngineMemoryAllocation &allocation) {
+    if (allocation.memory == VK_NULL_HANDLE) return;
+    std::lock_guard<std::mutex> lock{this->mutex};
+
+    if (allocation.isDedicated()) {
+      uint32_t heapIndex = this->memoryProperties.memoryTypes[allocation.memoryTypeIndex].heapIndex;
+      this->dedicatedSizes[heapIndex] -= allocation.size;
+      this->dedicatedCounts[heapIndex]--;
+
+      if (allocation.mapped != nullptr) {
+        vkUnmapMemory(this->device, allocation.memory);
+      }
+
+      vkFreeMemory(this->device, allocation.memory, nullptr);
+    } else {
+      EngineMemoryBlock* block = allocation.block;
+      block->ranges->free(allocation.offset, allocation.size);
+
+      // keep a single empty block per memory type around, so a resource that is
+      // destroyed and created again each frame does not hit vkAllocateMemory
+      if (block->ranges->isEmpty()) {
+        for (auto &&other : this->blocks) {
+          if (other.get() != block && other->memoryTypeIndex == block->memoryTypeIndex &&
+            other->kind == block->kind && other->ranges->isEmpty())
+          {
+            this->destroyBlock(block);
+            break;
+          }
+        }
+      }
+    }
+
+    allocation = EngineMemoryAllocation{};
+  }
+
+  /**
+   * Flush a range of the allocation to make host writes visible to the device
+   *
+   * @note Only does anything for non-coherent memory
+   *
+   * @param allocation The allocation to flush
+   * @param size (Optional) Size of the range to flush. Pass VK_WHOLE_SIZE to flush the whole allocation.
+   * @param offset (Optional) Byte offset from beginning of the allocation
+   *
+   * @return VkResult of the flush call
+   */
+  VkResult EngineMemoryAllocator::flush(const EngineMemoryAllocation &allocation, VkDeviceSize size, VkDeviceSize offset) {
+    if (this->isHostCoherent(allocation.memoryTypeIndex)) return VK_SUCCESS;
+
+    VkMappedMemoryRange mappedRange = this->getMappedRange(allocation, size, offset);
+    return vkFlushMappedMemoryRanges(this->device, 1, &mappedRange);
+  }
+
+  /**
+   * Invalidate a range of the allocation to make device writes visible to the host
+   *
+   * @note Only does anything for non-coherent memory
+   *
+   * @param allocation The allocation to invalidate
+   * @param size (Optional) Size of the range to invalidate. Pass VK_WHOLE_SIZE to invalidate the whole allocation.
+   * @param offset (Optional) Byte offset from beginning of the allocation
+   *
+   * @return VkResult of the invalidate call
+   */
+  VkResult EngineMemoryAllocator::invalidate(const EngineMemoryAllocation &allocation, VkDeviceSize size, VkDeviceSize offset) {
+    if (this->isHostCoherent(allocation.memoryTypeIndex)) return VK_SUCCESS;
+
+    VkMappedMemoryRange mappedRange = this->getMappedRange(allocation, size, offset);
+    return vkInvalidateMappedMemoryRanges(this->device, 1, &mappedRange);
+  }
+
+  uint32_t EngineMemoryAllocator::findMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags properties) const {
+    for (uint32_t i = 0; i < this->memoryProperties.memoryTypeCount; i++) {
+      if ((typeFilter & (1 << i)) &&
+          (this->memoryProperties.memoryTypes[i].propertyFlags & properties) == properties) {
+        return i;
+      }
+    }
+
+    throw std::runtime_error("failed to find suitable memory type!");
+  }
+
+  std::vector<EngineMemoryHeapStats> EngineMemoryAllocator::getHeapStats() {
+    std::lock_guard<std::mutex> lock{this->mutex};
+    std::vector<EngineMemoryHeapStats> stats(this->memoryProperties.memoryHeapCount);
+
+    for (uint32_t i = 0; i < this->memoryProperties.memoryHeapCount; i++) {
+      stats[i].heapSize = this->memoryProperties.memoryHeaps[i].size;
+      stats[i].reservedSize = this->dedicatedSizes[i];
+      stats[i].usedSize = this->dedicatedSizes[i];
+      stats[i].dedicatedCount = this->dedicatedCounts[i];
+      stats[i].allocationCount = this->dedicatedCounts[i];
+    }
+
+    for (auto &&block : this->blocks) {
+      auto &heapStats = stats[this->memoryProperties.memoryTypes[block->memoryTypeIndex].heapIndex];
+
+      heapStats.reservedSize += block->size;
+      heapStats.usedSize += block->ranges->getUsedSize();
+      heapStats.largestFreeRange = std::max(heapStats.largestFreeRange, block->ranges->getLargestFreeRange());
+      heapStats.blockCount++;
+      heapStats.allocationCount += block->ranges->getAllocationCount();
+    }
+
+    return stats;
+  }
+
+  void EngineMemoryAllocator::printStats() {
+    const double mib = 1024.0 * 1024.0;
+    auto stats = this->getHeapStats();
+
+    std::cout << "device memory usage:" << std::endl;
+    for (size_t i = 0; i < stats.size(); i++) {
+      if (stats[i].reservedSize == 0) continue;
+
+      std::cout << std::fixed << std::setprecision(2)
+        << "  heap " << i << ": " << stats[i].usedSize / mib << " / " << stats[i].reservedSize / mib
+        << " MiB used in " << stats[i].blockCount << " blocks + " << stats[i].dedicatedCount << " dedicated, "
+        << stats[i].allocationCount << " allocations, heap size " << stats[i].heapSize / mib << " MiB, "
+        << "fragmentation " << stats[i].fragmentation() * 100.0f << "%" << std::endl;
+    }
+  }
+
+  EngineMemoryBlock* EngineMemoryAllocator::createBlock(uint32_t memoryTypeIndex, EngineMemoryResourceKind kind, VkDeviceSize size) {
+    auto block = std::make_unique<EngineMemoryBlock>();
+    block->size = size;
+    block->memoryTypeIndex = memoryTypeIndex;
+    block->kind = kind;
+    block->ranges = std::make_unique<EngineRangeAllocator>(size);
+
+    VkMemoryAllocateInfo allocInfo{};
+    allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+    allocInfo.allocationSize = size;
+    allocInfo.memoryTypeIndex = memoryTypeIndex;
+
+    if (vkAllocateMemory(this->device, &allocInfo, nullptr, &block->memory) != VK_SUCCESS) {
+      throw std::runtime_error("failed to allocate memory block!");
+    }
+
+    // host visible blocks stay mapped for their whole lifetime
+    if (this->isHostVisible(memoryTypeIndex)) {
+      if (vkMapMemory(this->device, block->memory, 0, VK_WHOLE_SIZE, 0, &block->mapped) != VK_SUCCESS) {
+        throw std::runtime_error("failed to map memory block!");
+      }
+    }
+
+    this->blocks.emplace_back(std::move(block));
+    return this->blocks.back().get();
+  }
+
+  void EngineMemoryAllocator::destroyBlock(EngineMemoryBlock* block) {
+    auto it = std::find_if(this->blocks.begin(), this->blocks.end(),
+      [block](const std::unique_ptr<EngineMemoryBlock> &other) { return other.get() == block; });
+    assert(it != this->blocks.end() && "Block is not owned by this allocator");
+
+    if (block->mapped != nullptr) {
+      vkUnmapMemory(this->device, block->memory);
+    }
+
+    vkFreeMemory(this->device, block->memory, nullptr);
+    this->blocks.erase(it);
+  }
+
+  EngineMemoryAllocation EngineMemoryAllocator::allocateDedicated(uint32_t memoryTypeIndex, VkDeviceSize size) {
+    EngineMemoryAllocation allocation{};
+    allocation.size = size;
+    allocation.memoryTypeIndex = memoryTypeIndex;
+
+    VkMemoryAllocateInfo allocInfo{};
+    allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+    allocInfo.allocationSize = size;
+    allocInfo.memoryTypeIndex = memoryTypeIndex;
+
+    if (vkAllocateMemory(this->device, &allocInfo, nullptr, &allocation.memory) != VK_SUCCESS) {
+      throw std::runtime_error("failed to allocate dedicated memory!");
+    }
+
+    if (this->isHostVisible(memoryTypeIndex)) {
+      if (vkMapMemory(this->device, allocation.memory, 0, VK_WHOLE_SIZE, 0, &allocation.mapped) != VK_SUCCESS) {
+        throw std::runtime_error("failed to map dedicated memory!");
+      }
+    }
+
+    uint32_t heapIndex = this->memoryProperties.memoryTypes[memoryTypeIndex].heapIndex;
+    this->dedicatedSizes[heapIndex] += size;
+    this->dedicatedCounts[heapIndex]++;
+
+    return allocation;
+  }
+
+  VkDeviceSize EngineMemoryAllocator::getBlockSize(uint32_t memoryTypeIndex) const {
+    uint32_t heapIndex = this->memoryProperties.memoryTypes[memoryTypeIndex].heapIndex;
+    VkDeviceSize heapSize = this->memoryProperties.memoryHeaps[heapIndex].size;
+
+    // small heaps (e.g. the 256 MiB device local + host visible BAR heap) get smaller blocks
+    if (heapSize <= 1024ULL * 1024 * 1024) {
+      return alignUp(heapSize / 8, this->nonCoherentAtomSize);
+    }
+
+    return EngineMemoryAllocator::defaultBlockSize;
+  }
+
+  bool EngineMemoryAllocator::isHostVisible(uint32_t memoryTypeIndex) const {
+    return (this->memoryProperties.memoryTypes[memoryTypeIndex].propertyFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) != 0;
+  }
+
+  bool EngineMemoryAllocator::isHostCoherent(uint32_t memoryTypeIndex) const {
+    return (this->memoryProperties.memoryTypes[memoryTypeIndex].propertyFlags & VK_MEMORY_PROPERTY_HOST_COHERENT_BIT) != 0;
+  }
+
+  VkMappedMemoryRange EngineMemoryAllocator::getMappedRange(const EngineMemoryAllocation &allocation, VkDeviceSize size, VkDeviceSize offset) const {
+    VkDeviceSize memorySize = allocation.isDedicated() ? allocation.size : allocation.block->size;
+    VkDeviceSize rangeEnd = (size == VK_WHOLE_SIZE)
+      ? allocation.offset + allocation.size
+      : allocation.offset + offset + size;
+
+    VkMappedMemoryRange mappedRange = {};
+    mappedRange.sType = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE;
+    mappedRange.memory = allocation.memory;
+    mappedRange.offset = alignDown(allocation.offset + offset, this->nonCoherentAtomSize);
+
+    rangeEnd = alignUp(rangeEnd, this->nonCoherentAtomSize);
+    mappedRange.size = (rangeEnd >= memorySize) ? VK_WHOLE_SIZE : rangeEnd - mappedRange.offset;
+
+    return mappedRange;
+  }
+
+} // namespace nugiEngine
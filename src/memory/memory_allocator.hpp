@@ -0,0 +1,96 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include "range_allocator.hpp"
+
+// std lib headers
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace nugiEngine {
+  // Resources that are bound next to each other must respect bufferImageGranularity
+  // when one of them is linear (buffer, linear image) and the other is optimal tiled image
+  enum class EngineMemoryResourceKind {
+    Linear = 0,
+    Optimal = 1
+  };
+
+  struct EngineMemoryBlock {
+    VkDeviceMemory memory = VK_NULL_HANDLE;
+    VkDeviceSize size = 0;
+    uint32_t memoryTypeIndex = 0;
+    EngineMemoryResourceKind kind = EngineMemoryResourceKind::Linear;
+    void* mapped = nullptr;
+    std::unique_ptr<EngineRangeAllocator> ranges;
+  };
+
+  struct EngineMemoryAllocation {
+    VkDeviceMemory memory = VK_NULL_HANDLE;
+    VkDeviceSize offset = 0;
+    VkDeviceSize size = 0;
+    uint32_t memoryTypeIndex = 0;
+    void* mapped = nullptr;
+
+    // nullptr when the allocation got its own VkDeviceMemory
+    EngineMemoryBlock* block = nullptr;
+
+    bool isDedicated() const { return this->block == nullptr; }
+  };
+
+  struct EngineMemoryHeapStats {
+    VkDeviceSize heapSize = 0;
+    VkDeviceSize reservedSize = 0;
+    VkDeviceSize usedSize = 0;
+    VkDeviceSize largestFreeRange = 0;
+    uint32_t blockCount = 0;
+    uint32_t dedicatedCount = 0;
+    uint32_t allocationCount = 0;
+
+    // 0 means every free byte of the blocks is one contiguous range
+    float fragmentation() const;
+  };
+
+  class EngineMemoryAllocator {
+    public:
+      static constexpr VkDeviceSize defaultBlockSize = 64ULL * 1024 * 1024;
+
+      EngineMemoryAllocator(VkPhysicalDevice physicalDevice, VkDevice device);
+      ~EngineMemoryAllocator();
+
+      EngineMemoryAllocator(const EngineMemoryAllocator &) = delete;
+      EngineMemoryAllocator &operator=(const EngineMemoryAllocator &) = delete;
+
+      EngineMemoryAllocation allocate(VkMemoryRequirements requirements, VkMemoryPropertyFlags properties, EngineMemoryResourceKind kind);
+      void free(EngineMemoryAllocation &allocation);
+
+      VkResult flush(const EngineMemoryAllocation &allocation, VkDeviceSize size = VK_WHOLE_SIZE, VkDeviceSize offset = 0);
+      VkResult invalidate(const EngineMemoryAllocation &allocation, VkDeviceSize size = VK_WHOLE_SIZE, VkDeviceSize offset = 0);
+
+      uint32_t findMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags properties) const;
+      std::vector<EngineMemoryHeapStats> getHeapStats();
+      void printStats();
+
+    private:
+      VkDevice device;
+      VkPhysicalDeviceMemoryProperties memoryProperties;
+      VkDeviceSize bufferImageGranularity;
+      VkDeviceSize nonCoherentAtomSize;
+
+      std::vector<std::unique_ptr<EngineMemoryBlock>> blocks;
+      std::vector<VkDeviceSize> dedicatedSizes; // per heap
+      std::vector<uint32_t> dedicatedCounts; // per heap
+      std::mutex mutex;
+
+      EngineMemoryBlock* createBlock(uint32_t memoryTypeIndex, EngineMemoryResourceKind kind, VkDeviceSize size);
+      void destroyBlock(EngineMemoryBlock* block);
+      EngineMemoryAllocation allocateDedicated(uint32_t memoryTypeIndex, VkDeviceSize size);
+
+      VkDeviceSize getBlockSize(uint32_t memoryTypeIndex) const;
+      bool isHostVisible(uint32_t memoryTypeIndex) const;
+      bool isHostCoherent(uint32_t memoryTypeIndex) const;
+      VkMappedMemoryRange getMappedRange(const EngineMemoryAllocation &allocation, VkDeviceSize size, VkDeviceSize offset) const;
+  };
+
+} // namespace nugiEngine
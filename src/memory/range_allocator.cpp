@@ -0,0 +1,92 @@
+#include "range_allocator.hpp"
+
+#include <cassert>
+#include <iterator>
+
+namespace nugiEngine {
+  EngineRangeAllocator::EngineRangeAllocator(VkDeviceSize capacity) : capacity{capacity} {
+    this->freeRanges[0] = capacity;
+  }
+
+  VkDeviceSize EngineRangeAllocator::allocate(VkDeviceSize size, VkDeviceSize alignment) {
+    assert(size > 0 && "Cannot allocate empty range");
+    if (alignment == 0) alignment = 1;
+
+    // best fit: take the smallest free range that still holds the aligned request
+    auto best = this->freeRanges.end();
+    VkDeviceSize bestAlignedOffset = 0;
+
+    for (auto it = this->freeRanges.begin(); it != this->freeRanges.end(); it++) {
+      VkDeviceSize alignedOffset = (it->first + alignment - 1) / alignment * alignment;
+      VkDeviceSize padding = alignedOffset - it->first;
+
+      if (it->second < padding + size) continue;
+
+      if (best == this->freeRanges.end() || it->second < best->second) {
+        best = it;
+        bestAlignedOffset = alignedOffset;
+      }
+    }
+
+    if (best == this->freeRanges.end()) {
+      return EngineRangeAllocator::invalidOffset;
+    }
+
+    VkDeviceSize rangeOffset = best->first;
+    VkDeviceSize rangeSize = best->second;
+    this->freeRanges.erase(best);
+
+    // give back the alignment padding in front and the tail behind the allocation
+    if (bestAlignedOffset > rangeOffset) {
+      this->freeRanges[rangeOffset] = bestAlignedOffset - rangeOffset;
+    }
+
+    VkDeviceSize allocationEnd = bestAlignedOffset + size;
+    VkDeviceSize rangeEnd = rangeOffset + rangeSize;
+    if (rangeEnd > allocationEnd) {
+      this->freeRanges[allocationEnd] = rangeEnd - allocationEnd;
+    }
+
+    this->usedSize += size;
+    this->allocationCount++;
+
+    return bestAlignedOffset;
+  }
+
+  void EngineRangeAllocator::free(VkDeviceSize offset, VkDeviceSize size) {
+    assert(offset + size <= this->capacity && "Freed range is outside of the allocator");
+    assert(this->allocationCount > 0 && "Free called on empty allocator");
+
+    this->usedSize -= size;
+    this->allocationCount--;
+
+    auto next = this->freeRanges.lower_bound(offset);
+
+    // merge with the following free range
+    if (next != this->freeRanges.end() && next->first == offset + size) {
+      size += next->second;
+      next = this->freeRanges.erase(next);
+    }
+
+    // merge with the preceding free range
+    if (next != this->freeRanges.begin()) {
+      auto prev = std::prev(next);
+      if (prev->first + prev->second == offset) {
+        prev->second += size;
+        return;
+      }
+    }
+
+    this->freeRanges[offset] = size;
+  }
+
+  VkDeviceSize EngineRangeAllocator::getLargestFreeRange() const {
+    VkDeviceSize largest = 0;
+    for (auto &&range : this->freeRanges) {
+      if (range.second > largest) largest = range.second;
+    }
+
+    return largest;
+  }
+
+} // namespace nugiEngine
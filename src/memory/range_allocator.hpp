@@ -0,0 +1,36 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include <map>
+
+namespace nugiEngine {
+  // Free-list allocator over an abstract [0, capacity) range. It only does the
+  // bookkeeping; the owner decides what the offsets point into (device memory,
+  // a big vertex buffer, ...).
+  class EngineRangeAllocator {
+    public:
+      static constexpr VkDeviceSize invalidOffset = ~0ULL;
+
+      EngineRangeAllocator(VkDeviceSize capacity);
+
+      VkDeviceSize allocate(VkDeviceSize size, VkDeviceSize alignment = 1);
+      void free(VkDeviceSize offset, VkDeviceSize size);
+
+      VkDeviceSize getCapacity() const { return this->capacity; }
+      VkDeviceSize getUsedSize() const { return this->usedSize; }
+      VkDeviceSize getFreeSize() const { return this->capacity - this->usedSize; }
+      VkDeviceSize getLargestFreeRange() const;
+      uint32_t getAllocationCount() const { return this->allocationCount; }
+      bool isEmpty() const { return this->allocationCount == 0; }
+
+    private:
+      VkDeviceSize capacity;
+      VkDeviceSize usedSize = 0;
+      uint32_t allocationCount = 0;
+
+      // offset -> size, kept sorted so neighbours can be merged on free
+      std::map<VkDeviceSize, VkDeviceSize> freeRanges;
+  };
+
+} // namespace nugiEngine
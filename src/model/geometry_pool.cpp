@@ -0,0 +1,81 @@
+#include "geometry_pool.hpp"
+
+#include <stdexcept>
+
+namespace nugiEngine {
+	EngineGeometryPool::EngineGeometryPool(EngineDevice &device, uint32_t maxVertexCount, uint32_t maxIndexCount)
+		: engineDevice{device}, vertexRanges{maxVertexCount}, indexRanges{maxIndexCount}
+	{
+		this->vertexBuffer = std::make_unique<EngineBuffer>(
+			this->engineDevice,
+			sizeof(Vertex),
+			maxVertexCount,
+			VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+			VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT
+		);
+
+		this->indexBuffer = std::make_unique<EngineBuffer>(
+			this->engineDevice,
+			sizeof(uint32_t),
+			maxIndexCount,
+			VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+			VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT
+		);
+	}
+
+	EngineMeshAllocation EngineGeometryPool::allocateMesh(const EngineMeshView &data) {
+		EngineMeshAllocation mesh{};
+		mesh.vertexCount = data.vertexCount;
+		mesh.indexCount = data.indexCount;
+
+		{
+			std::lock_guard<std::mutex> lock{this->mutex};
+
+			VkDeviceSize firstVertex = this->vertexRanges.allocate(mesh.vertexCount);
+			if (firstVertex == EngineRangeAllocator::invalidOffset) {
+				throw std::runtime_error("geometry pool is out of vertex space!");
+			}
+
+			mesh.firstVertex = static_cast<uint32_t>(firstVertex);
+
+			if (mesh.indexCount > 0) {
+				VkDeviceSize firstIndex = this->indexRanges.allocate(mesh.indexCount);
+				if (firstIndex == EngineRangeAllocator::invalidOffset) {
+					this->vertexRanges.free(firstVertex, mesh.vertexCount);
+					throw std::runtime_error("geometry pool is out of index space!");
+				}
+
+				mesh.firstIndex = static_cast<uint32_t>(firstIndex);
+			}
+		}
+
+		auto uploadService = this->engineDevice.getUploadService();
+
+		mesh.uploadHandle = uploadService->uploadBuffer(*this->vertexBuffer, data.vertices,
+			sizeof(Vertex) * mesh.vertexCount, sizeof(Vertex) * mesh.firstVertex);
+
+		if (mesh.indexCount > 0) {
+			mesh.uploadHandle = uploadService->uploadBuffer(*this->indexBuffer, data.indices,
+				sizeof(uint32_t) * mesh.indexCount, sizeof(uint32_t) * mesh.firstIndex);
+		}
+
+		return mesh;
+	}
+
+	void EngineGeometryPool::freeMesh(const EngineMeshAllocation &mesh) {
+		std::lock_guard<std::mutex> lock{this->mutex};
+
+		this->vertexRanges.free(mesh.firstVertex, mesh.vertexCount);
+		if (mesh.indexCount > 0) {
+			this->indexRanges.free(mesh.firstIndex, mesh.indexCount);
+		}
+	}
+
+	void EngineGeometryPool::bind(std::shared_ptr<EngineCommandBuffer> commandBuffer) {
+		VkBuffer buffers[] = {this->vertexBuffer->getBuffer()};
+		VkDeviceSize offsets[] = {0};
+		vkCmdBindVertexBuffers(commandBuffer->getCommandBuffer(), 0, 1, buffers, offsets);
+		vkCmdBindIndexBuffer(commandBuffer->getCommandBuffer(), this->indexBuffer->getBuffer(), 0, VK_INDEX_TYPE_UINT32);
+	}
+
+} // namespace nugiEngine
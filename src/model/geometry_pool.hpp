@@ -0,0 +1,42 @@
+#pragma once
+
+#include "model.hpp"
+#include "../memory/range_allocator.hpp"
+
+#include <memory>
+#include <mutex>
+
+namespace nugiEngine
+{
+	// One big vertex buffer and one big index buffer shared by every model, so a
+	// render pass binds geometry once and draws with base vertex / first index
+	class EngineGeometryPool
+	{
+	public:
+		EngineGeometryPool(EngineDevice &device, uint32_t maxVertexCount, uint32_t maxIndexCount);
+
+		EngineGeometryPool(const EngineGeometryPool&) = delete;
+		EngineGeometryPool& operator = (const EngineGeometryPool&) = delete;
+
+		// the data is copied to staging memory before returning, so it may go away right after
+		EngineMeshAllocation allocateMesh(const EngineMeshView &data);
+		void freeMesh(const EngineMeshAllocation &mesh);
+
+		void bind(std::shared_ptr<EngineCommandBuffer> commandBuffer);
+
+		VkBuffer getVertexBuffer() const { return this->vertexBuffer->getBuffer(); }
+		VkBuffer getIndexBuffer() const { return this->indexBuffer->getBuffer(); }
+
+	private:
+		EngineDevice &engineDevice;
+
+		std::unique_ptr<EngineBuffer> vertexBuffer;
+		std::unique_ptr<EngineBuffer> indexBuffer;
+
+		// both count elements, not bytes
+		EngineRangeAllocator vertexRanges;
+		EngineRangeAllocator indexRanges;
+
+		std::mutex mutex;
+	};
+} // namespace nugiEngine
@@ -0,0 +1,158 @@
+#include "mesh_cache.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <system_error>
+
+namespace nugiEngine {
+	namespace {
+		constexpr char MESH_CACHE_MAGIC[4] = { 'N', 'M', 'S', 'H' };
+
+		// arrays start on this boundary, so the mapped pointers are aligned for Vertex & uint32_t
+		constexpr uint64_t MESH_CACHE_ALIGNMENT = 16;
+
+		uint64_t alignOffset(uint64_t offset) {
+			return (offset + MESH_CACHE_ALIGNMENT - 1) & ~(MESH_CACHE_ALIGNMENT - 1);
+		}
+
+		bool getSourceStamp(const std::string &sourcePath, uint64_t &size, int64_t &modifiedTime) {
+			std::error_code error;
+
+			size = static_cast<uint64_t>(std::filesystem::file_size(sourcePath, error));
+			if (error) return false;
+
+			modifiedTime = static_cast<int64_t>(std::filesystem::last_write_time(sourcePath, error).time_since_epoch().count());
+			return !error;
+		}
+
+		// whether count elements of stride bytes fit in the file from offset on, without overflowing
+		bool isRangeInFile(uint64_t offset, uint64_t count, uint64_t stride, uint64_t fileSize) {
+			return offset <= fileSize && count <= (fileSize - offset) / stride;
+		}
+	}
+
+	EngineMeshCache::EngineMeshCache(std::unique_ptr<EngineMappedFile> file) 
+		: file{std::move(file)}, header{reinterpret_cast<const EngineMeshCacheHeader*>(this->file->getData())} {}
+
+	std::unique_ptr<EngineMeshCache> EngineMeshCache::open(const std::string &sourcePath) {
+		uint64_t sourceSize = 0;
+		int64_t sourceModifiedTime = 0;
+
+		if (!getSourceStamp(sourcePath, sourceSize, sourceModifiedTime)) return nullptr;
+
+		auto file = EngineMappedFile::open(EngineMeshCache::getCachePath(sourcePath));
+		if (file == nullptr || file->getSize() < sizeof(EngineMeshCacheHeader)) return nullptr;
+
+		auto header = reinterpret_cast<const EngineMeshCacheHeader*>(file->getData());
+
+		if (std::memcmp(header->magic, MESH_CACHE_MAGIC, sizeof(MESH_CACHE_MAGIC)) != 0 || header->version != EngineMeshCache::VERSION 
+			|| header->vertexStride != sizeof(Vertex)) 
+		{
+			return nullptr;
+		}
+
+		if (header->sourceSize != sourceSize || header->sourceModifiedTime != sourceModifiedTime) return nullptr;
+
+		// never trust the offsets & counts of a truncated or damaged file
+		if (header->vertexCount < 3 || header->vertexOffset % MESH_CACHE_ALIGNMENT != 0 || header->indexOffset % MESH_CACHE_ALIGNMENT != 0
+			|| header->vertexOffset < sizeof(EngineMeshCacheHeader) || !isRangeInFile(header->vertexOffset, header->vertexCount, sizeof(Vertex), file->getSize()) 
+			|| !isRangeInFile(header->indexOffset, header->indexCount, sizeof(uint32_t), file->getSize())) 
+		{
+			return nullptr;
+		}
+
+		// nor its indices, one past the vertices would read out of the vertex buffer on the GPU
+		auto indices = reinterpret_cast<const uint32_t*>(file->getData() + header->indexOffset);
+		for (uint32_t i = 0; i < header->indexCount; i++) {
+			if (indices[i] >= header->vertexCount) return nullptr;
+		}
+
+		return std::unique_ptr<EngineMeshCache>{new EngineMeshCache(std::move(file))};
+	}
+
+	bool EngineMeshCache::write(const std::string &sourcePath, const EngineMeshView &mesh, const EngineBoundingBox &boundingBox, glm::vec4 boundingSphere) {
+		EngineMeshCacheHeader header{};
+		std::memcpy(header.magic, MESH_CACHE_MAGIC, sizeof(MESH_CACHE_MAGIC));
+		header.version = EngineMeshCache::VERSION;
+		header.vertexStride = sizeof(Vertex);
+		header.vertexCount = mesh.vertexCount;
+		header.indexCount = mesh.indexCount;
+		header.vertexOffset = alignOffset(sizeof(EngineMeshCacheHeader));
+		header.indexOffset = alignOffset(header.vertexOffset + static_cast<uint64_t>(mesh.vertexCount) * sizeof(Vertex));
+		header.boundingBox = boundingBox;
+		header.boundingSphere = boundingSphere;
+
+		if (!getSourceStamp(sourcePath, header.sourceSize, header.sourceModifiedTime)) return false;
+
+		// written under a temporary name first, so a crash never leaves a half written cache behind
+		std::string cachePath = EngineMeshCache::getCachePath(sourcePath);
+		std::string tempPath = cachePath + ".tmp";
+
+		{
+			std::ofstream stream{tempPath, std::ios::binary | std::ios::trunc};
+			if (!stream.is_open()) return false;
+
+			const char zeros[MESH_CACHE_ALIGNMENT] = {};
+			auto padTo = [&stream, &zeros](uint64_t offset) {
+				uint64_t position = static_cast<uint64_t>(stream.tellp());
+				stream.write(zeros, static_cast<std::streamsize>(offset - position));
+			};
+
+			stream.write(reinterpret_cast<const char*>(&header), sizeof(EngineMeshCacheHeader));
+
+			padTo(header.vertexOffset);
+			stream.write(reinterpret_cast<const char*>(mesh.vertices), static_cast<std::streamsize>(sizeof(Vertex) * mesh.vertexCount));
+
+			padTo(header.indexOffset);
+			stream.write(reinterpret_cast<const char*>(mesh.indices), static_cast<std::streamsize>(sizeof(uint32_t) * mesh.indexCount));
+
+			if (!stream.good()) {
+				stream.close();
+				std::remove(tempPath.c_str());
+				return false;
+			}
+		}
+
+		std::error_code error;
+		std::filesystem::rename(tempPath, cachePath, error);
+
+		if (error) {
+			std::remove(tempPath.c_str());
+			return false;
+		}
+
+		return true;
+	}
+
+	void EngineMeshCache::convert(const std::string &sourcePath, EngineThreadPool &threadPool) {
+		ModelData modelData;
+		modelData.loadModel(sourcePath, threadPool);
+
+		if (modelData.vertices.size() < 3) {
+			throw std::runtime_error("mesh has less than 3 vertices: " + sourcePath);
+		}
+
+		EngineBoundingBox boundingBox{};
+		glm::vec4 boundingSphere{0.0f};
+		EngineModel::computeBounds(modelData.getMeshView(), boundingBox, boundingSphere);
+
+		if (!EngineMeshCache::write(sourcePath, modelData.getMeshView(), boundingBox, boundingSphere)) {
+			throw std::runtime_error("failed to write the mesh cache of " + sourcePath);
+		}
+	}
+
+	EngineMeshView EngineMeshCache::getMesh() const {
+		const uint8_t* data = this->file->getData();
+
+		EngineMeshView mesh{};
+		mesh.vertices = reinterpret_cast<const Vertex*>(data + this->header->vertexOffset);
+		mesh.vertexCount = this->header->vertexCount;
+		mesh.indices = this->header->indexCount > 0 ? reinterpret_cast<const uint32_t*>(data + this->header->indexOffset) : nullptr;
+		mesh.indexCount = this->header->indexCount;
+
+		return mesh;
+	}
+} // namespace nugiEngine
@@ -0,0 +1,64 @@
+#pragma once
+
+#include "model.hpp"
+#include "../utils/mapped_file.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace nugiEngine
+{
+	// start of a .nmesh file; the vertex & index arrays follow at the given offsets, stored the way
+	// the geometry pool wants them
+	struct EngineMeshCacheHeader {
+		char magic[4];
+		uint32_t version = 0;
+		uint32_t vertexStride = 0; // sizeof(Vertex) when written, a layout change makes the cache stale
+		uint32_t vertexCount = 0;
+		uint32_t indexCount = 0;
+		uint32_t padding = 0;
+		uint64_t vertexOffset = 0;
+		uint64_t indexOffset = 0;
+
+		// the source file the cache was built from, it is rebuilt when either one changes
+		uint64_t sourceSize = 0;
+		int64_t sourceModifiedTime = 0;
+
+		EngineBoundingBox boundingBox{};
+		glm::vec4 boundingSphere{0.0f};
+	};
+
+	/**
+	 * Binary cache of a parsed & deduplicated mesh, written next to its source as <source>.nmesh on
+	 * first load or ahead of time by convert(). Opening one maps the file and hands out pointers into
+	 * the mapping, so loading is a copy into the staging ring with no parsing at all.
+	 */
+	class EngineMeshCache
+	{
+	public:
+		static constexpr uint32_t VERSION = 2;
+
+		static std::string getCachePath(const std::string &sourcePath) { return sourcePath + ".nmesh"; }
+
+		// null when there is no cache for sourcePath, or it is stale, from another version or damaged
+		static std::unique_ptr<EngineMeshCache> open(const std::string &sourcePath);
+
+		// false when the cache could not be written, e.g. the asset folder is read-only
+		static bool write(const std::string &sourcePath, const EngineMeshView &mesh, const EngineBoundingBox &boundingBox, glm::vec4 boundingSphere);
+
+		// parses sourcePath and writes its cache, for baking assets offline
+		static void convert(const std::string &sourcePath, EngineThreadPool &threadPool);
+
+		// valid as long as this cache is alive
+		EngineMeshView getMesh() const;
+		const EngineBoundingBox& getBoundingBox() const { return this->header->boundingBox; }
+		glm::vec4 getBoundingSphere() const { return this->header->boundingSphere; }
+
+	private:
+		EngineMeshCache(std::unique_ptr<EngineMappedFile> file);
+
+		std::unique_ptr<EngineMappedFile> file;
+		const EngineMeshCacheHeader* header;
+	};
+} // namespace nugiEngine
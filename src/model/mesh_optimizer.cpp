@@ -0,0 +1,351 @@
+#include "mesh_optimizer.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace nugiEngine {
+	namespace {
+		// scoring constants from Forsyth's "Linear-Speed Vertex Cache Optimisation"
+		constexpr uint32_t FORSYTH_CACHE_SIZE = 32;
+		constexpr float FORSYTH_CACHE_DECAY_POWER = 1.5f;
+		constexpr float FORSYTH_LAST_TRIANGLE_SCORE = 0.75f;
+		constexpr float FORSYTH_VALENCE_BOOST_SCALE = 2.0f;
+		constexpr float FORSYTH_VALENCE_BOOST_POWER = 0.5f;
+
+		constexpr uint32_t INVALID_INDEX = 0xFFFFFFFF;
+
+		constexpr uint32_t FORSYTH_VALENCE_TABLE_SIZE = 64;
+
+		// pow is the hot spot of the optimizer, both score parts are looked up instead
+		struct ForsythScoreTable {
+			float cacheScores[FORSYTH_CACHE_SIZE];
+			float valenceScores[FORSYTH_VALENCE_TABLE_SIZE];
+
+			ForsythScoreTable() {
+				for (uint32_t i = 0; i < FORSYTH_CACHE_SIZE; i++) {
+					// the three vertices of the last triangle score the same, whatever order they went in
+					this->cacheScores[i] = i < 3 ? FORSYTH_LAST_TRIANGLE_SCORE
+						: std::pow(1.0f - static_cast<float>(i - 3) / static_cast<float>(FORSYTH_CACHE_SIZE - 3), FORSYTH_CACHE_DECAY_POWER);
+				}
+
+				// finishes off vertices with few triangles left, so they do not linger as lone triangles
+				this->valenceScores[0] = 0.0f;
+				for (uint32_t i = 1; i < FORSYTH_VALENCE_TABLE_SIZE; i++) {
+					this->valenceScores[i] = FORSYTH_VALENCE_BOOST_SCALE * std::pow(static_cast<float>(i), -FORSYTH_VALENCE_BOOST_POWER);
+				}
+			}
+
+			float getVertexScore(int32_t cachePosition, uint32_t remainingTriangles) const {
+				// nothing left to draw with this vertex
+				if (remainingTriangles == 0) return -1.0f;
+
+				float score = cachePosition >= 0 ? this->cacheScores[cachePosition] : 0.0f;
+
+				return score + (remainingTriangles < FORSYTH_VALENCE_TABLE_SIZE ? this->valenceScores[remainingTriangles]
+					: FORSYTH_VALENCE_BOOST_SCALE * std::pow(static_cast<float>(remainingTriangles), -FORSYTH_VALENCE_BOOST_POWER));
+			}
+		};
+
+		// FIFO cache simulated with timestamps: a vertex is cached while fewer than cacheSize misses came after it
+		class FifoCache {
+			public:
+				FifoCache(size_t vertexCount, uint32_t cacheSize) : timestamps(vertexCount, 0), cacheSize{cacheSize}, time{cacheSize + 1} {}
+
+				uint32_t drawTriangle(const uint32_t* triangle) {
+					uint32_t missCount = 0;
+
+					for (uint32_t corner = 0; corner < 3; corner++) {
+						if (this->time - this->timestamps[triangle[corner]] > this->cacheSize) {
+							this->timestamps[triangle[corner]] = this->time++;
+							missCount++;
+						}
+					}
+
+					return missCount;
+				}
+
+				void flush() { this->time += this->cacheSize + 1; }
+
+			private:
+				std::vector<uint32_t> timestamps;
+				uint32_t cacheSize;
+				uint32_t time;
+		};
+	}
+
+	void EngineMeshOptimizer::optimize(std::vector<Vertex> &vertices, std::vector<uint32_t> &indices, float overdrawThreshold) {
+		EngineMeshOptimizer::optimizeVertexCache(indices, vertices.size());
+		EngineMeshOptimizer::optimizeOverdraw(indices, vertices, overdrawThreshold);
+		EngineMeshOptimizer::optimizeVertexFetch(vertices, indices);
+	}
+
+	void EngineMeshOptimizer::optimizeVertexCache(std::vector<uint32_t> &indices, size_t vertexCount) {
+		const size_t triangleCount = indices.size() / 3;
+		if (triangleCount == 0) return;
+
+		// per vertex triangle lists; the first remainingTriangles entries of each are the ones not drawn yet
+		std::vector<uint32_t> remainingTriangles(vertexCount, 0);
+		for (uint32_t index : indices) {
+			remainingTriangles[index]++;
+		}
+
+		std::vector<uint32_t> triangleOffsets(vertexCount + 1, 0);
+		for (size_t v = 0; v < vertexCount; v++) {
+			triangleOffsets[v + 1] = triangleOffsets[v] + remainingTriangles[v];
+		}
+
+		std::vector<uint32_t> vertexTriangles(indices.size());
+		std::vector<uint32_t> fillCounts(vertexCount, 0);
+
+		for (size_t i = 0; i < indices.size(); i++) {
+			vertexTriangles[triangleOffsets[indices[i]] + fillCounts[indices[i]]++] = static_cast<uint32_t>(i / 3);
+		}
+
+		const ForsythScoreTable scoreTable{};
+		std::vector<float> vertexScores(vertexCount);
+
+		for (size_t v = 0; v < vertexCount; v++) {
+			vertexScores[v] = scoreTable.getVertexScore(-1, remainingTriangles[v]);
+		}
+
+		std::vector<float> triangleScores(triangleCount);
+		std::vector<uint8_t> isEmitted(triangleCount, 0);
+
+		for (size_t t = 0; t < triangleCount; t++) {
+			triangleScores[t] = vertexScores[indices[3 * t + 0]] + vertexScores[indices[3 * t + 1]] + vertexScores[indices[3 * t + 2]];
+		}
+
+		uint32_t bestTriangle = static_cast<uint32_t>(std::max_element(triangleScores.begin(), triangleScores.end()) - triangleScores.begin());
+		size_t inputCursor = 0;
+
+		std::vector<uint32_t> cache, newCache;
+		cache.reserve(FORSYTH_CACHE_SIZE + 3);
+		newCache.reserve(FORSYTH_CACHE_SIZE + 3);
+
+		std::vector<uint32_t> optimizedIndices;
+		optimizedIndices.reserve(indices.size());
+
+		for (size_t emittedCount = 0; emittedCount < triangleCount; emittedCount++) {
+			// dead end, nothing in the cache has triangles left: carry on in input order
+			if (bestTriangle == INVALID_INDEX) {
+				while (isEmitted[inputCursor]) inputCursor++;
+				bestTriangle = static_cast<uint32_t>(inputCursor);
+			}
+
+			const uint32_t* triangle = &indices[3 * bestTriangle];
+			optimizedIndices.insert(optimizedIndices.end(), triangle, triangle + 3);
+			isEmitted[bestTriangle] = 1;
+
+			newCache.clear();
+
+			for (uint32_t corner = 0; corner < 3; corner++) {
+				uint32_t vertex = triangle[corner];
+
+				// swap the drawn triangle behind the vertex's remaining ones
+				uint32_t* triangles = &vertexTriangles[triangleOffsets[vertex]];
+				uint32_t* drawnTriangle = std::find(triangles, triangles + remainingTriangles[vertex], bestTriangle);
+
+				std::swap(*drawnTriangle, triangles[--remainingTriangles[vertex]]);
+
+				if (std::find(newCache.begin(), newCache.end(), vertex) == newCache.end()) {
+					newCache.push_back(vertex);
+				}
+			}
+
+			const size_t triangleVertexCount = newCache.size();
+
+			for (uint32_t vertex : cache) {
+				auto triangleVerticesEnd = newCache.begin() + static_cast<std::ptrdiff_t>(triangleVertexCount);
+
+				if (std::find(newCache.begin(), triangleVerticesEnd, vertex) == triangleVerticesEnd) {
+					newCache.push_back(vertex);
+				}
+			}
+
+			// rescore every vertex that moved, including the ones pushed out, and their triangles with them
+			for (size_t i = 0; i < newCache.size(); i++) {
+				uint32_t vertex = newCache[i];
+				int32_t cachePosition = i < FORSYTH_CACHE_SIZE ? static_cast<int32_t>(i) : -1;
+
+				float score = scoreTable.getVertexScore(cachePosition, remainingTriangles[vertex]);
+				float scoreDelta = score - vertexScores[vertex];
+
+				vertexScores[vertex] = score;
+
+				for (uint32_t j = 0; j < remainingTriangles[vertex]; j++) {
+					triangleScores[vertexTriangles[triangleOffsets[vertex] + j]] += scoreDelta;
+				}
+			}
+
+			newCache.resize(std::min<size_t>(newCache.size(), FORSYTH_CACHE_SIZE));
+			std::swap(cache, newCache);
+
+			// the next triangle only comes from the cache, scanning every triangle would make this quadratic
+			bestTriangle = INVALID_INDEX;
+			float bestScore = -1.0f;
+
+			for (uint32_t vertex : cache) {
+				for (uint32_t j = 0; j < remainingTriangles[vertex]; j++) {
+					uint32_t candidate = vertexTriangles[triangleOffsets[vertex] + j];
+
+					if (triangleScores[candidate] > bestScore) {
+						bestScore = triangleScores[candidate];
+						bestTriangle = candidate;
+					}
+				}
+			}
+		}
+
+		indices.swap(optimizedIndices);
+	}
+
+	void EngineMeshOptimizer::optimizeOverdraw(std::vector<uint32_t> &indices, const std::vector<Vertex> &vertices, float threshold) {
+		const size_t triangleCount = indices.size() / 3;
+		if (triangleCount == 0) return;
+
+		// hard boundaries: triangles the cache order starts from scratch, all three corners missing
+		std::vector<uint32_t> triangleMisses(triangleCount);
+		std::vector<uint32_t> hardClusters;
+
+		FifoCache cache{vertices.size(), EngineMeshOptimizer::FIFO_CACHE_SIZE};
+
+		for (size_t t = 0; t < triangleCount; t++) {
+			triangleMisses[t] = cache.drawTriangle(&indices[3 * t]);
+			if (triangleMisses[t] == 3) hardClusters.push_back(static_cast<uint32_t>(t));
+		}
+
+		if (hardClusters.empty() || hardClusters[0] != 0) {
+			hardClusters.insert(hardClusters.begin(), 0);
+		}
+
+		hardClusters.push_back(static_cast<uint32_t>(triangleCount));
+
+		// soft boundaries: split a hard cluster wherever starting over with a cold cache stays within the threshold
+		std::vector<uint32_t> clusters;
+
+		for (size_t c = 0; c + 1 < hardClusters.size(); c++) {
+			const uint32_t clusterBegin = hardClusters[c], clusterEnd = hardClusters[c + 1];
+
+			uint32_t clusterMisses = 0;
+			for (uint32_t t = clusterBegin; t < clusterEnd; t++) {
+				clusterMisses += triangleMisses[t];
+			}
+
+			const float maxAcmr = threshold * static_cast<float>(clusterMisses) / static_cast<float>(clusterEnd - clusterBegin);
+
+			cache.flush();
+			clusters.push_back(clusterBegin);
+
+			uint32_t softBegin = clusterBegin, softMisses = 0;
+
+			for (uint32_t t = clusterBegin; t < clusterEnd; t++) {
+				softMisses += cache.drawTriangle(&indices[3 * t]);
+
+				if (t + 1 < clusterEnd && static_cast<float>(softMisses) <= maxAcmr * static_cast<float>(t + 1 - softBegin)) {
+					cache.flush();
+					clusters.push_back(t + 1);
+
+					softBegin = t + 1;
+					softMisses = 0;
+				}
+			}
+		}
+
+		clusters.push_back(static_cast<uint32_t>(triangleCount));
+
+		// clusters facing away from the mesh center are likelier to occlude the rest, so they go first
+		glm::vec3 meshCenter{0.0f};
+		float meshArea = 0.0f;
+
+		std::vector<glm::vec3> clusterCenters(clusters.size() - 1, glm::vec3{0.0f});
+		std::vector<glm::vec3> clusterNormals(clusters.size() - 1, glm::vec3{0.0f});
+
+		for (size_t c = 0; c + 1 < clusters.size(); c++) {
+			float clusterArea = 0.0f;
+
+			for (uint32_t t = clusters[c]; t < clusters[c + 1]; t++) {
+				const glm::vec3 &p0 = vertices[indices[3 * t + 0]].position;
+				const glm::vec3 &p1 = vertices[indices[3 * t + 1]].position;
+				const glm::vec3 &p2 = vertices[indices[3 * t + 2]].position;
+
+				glm::vec3 normal = glm::cross(p1 - p0, p2 - p0); // twice the area long
+				float area = glm::length(normal);
+
+				clusterCenters[c] += (p0 + p1 + p2) * (area / 3.0f);
+				clusterNormals[c] += normal;
+				clusterArea += area;
+			}
+
+			meshCenter += clusterCenters[c];
+			meshArea += clusterArea;
+
+			clusterCenters[c] = clusterArea > 0.0f ? clusterCenters[c] / clusterArea : vertices[indices[3 * clusters[c]]].position;
+		}
+
+		if (meshArea > 0.0f) meshCenter /= meshArea;
+
+		std::vector<float> clusterSortKeys(clusters.size() - 1, 0.0f);
+		for (size_t c = 0; c + 1 < clusters.size(); c++) {
+			float normalLength = glm::length(clusterNormals[c]);
+
+			if (normalLength > 0.0f) {
+				clusterSortKeys[c] = glm::dot(clusterCenters[c] - meshCenter, clusterNormals[c] / normalLength);
+			}
+		}
+
+		std::vector<uint32_t> clusterOrder(clusters.size() - 1);
+		for (uint32_t c = 0; c < clusterOrder.size(); c++) {
+			clusterOrder[c] = c;
+		}
+
+		std::stable_sort(clusterOrder.begin(), clusterOrder.end(), [&clusterSortKeys](uint32_t a, uint32_t b) {
+			return clusterSortKeys[a] > clusterSortKeys[b];
+		});
+
+		std::vector<uint32_t> sortedIndices;
+		sortedIndices.reserve(indices.size());
+
+		for (uint32_t c : clusterOrder) {
+			sortedIndices.insert(sortedIndices.end(), indices.begin() + 3 * clusters[c], indices.begin() + 3 * clusters[c + 1]);
+		}
+
+		indices.swap(sortedIndices);
+	}
+
+	void EngineMeshOptimizer::optimizeVertexFetch(std::vector<Vertex> &vertices, std::vector<uint32_t> &indices) {
+		std::vector<uint32_t> remap(vertices.size(), INVALID_INDEX);
+
+		std::vector<Vertex> fetchOrderedVertices;
+		fetchOrderedVertices.reserve(vertices.size());
+
+		// vertices no index refers to are dropped
+		for (uint32_t &index : indices) {
+			if (remap[index] == INVALID_INDEX) {
+				remap[index] = static_cast<uint32_t>(fetchOrderedVertices.size());
+				fetchOrderedVertices.push_back(vertices[index]);
+			}
+
+			index = remap[index];
+		}
+
+		vertices.swap(fetchOrderedVertices);
+	}
+
+	EngineVertexCacheStats EngineMeshOptimizer::analyzeVertexCache(const std::vector<uint32_t> &indices, size_t vertexCount, uint32_t cacheSize) {
+		const size_t triangleCount = indices.size() / 3;
+		if (triangleCount == 0 || vertexCount == 0) return EngineVertexCacheStats{};
+
+		FifoCache cache{vertexCount, cacheSize};
+		size_t missCount = 0;
+
+		for (size_t t = 0; t < triangleCount; t++) {
+			missCount += cache.drawTriangle(&indices[3 * t]);
+		}
+
+		EngineVertexCacheStats stats{};
+		stats.acmr = static_cast<float>(missCount) / static_cast<float>(triangleCount);
+		stats.atvr = static_cast<float>(missCount) / static_cast<float>(vertexCount);
+
+		return stats;
+	}
+} // namespace nugiEngine
@@ -0,0 +1,37 @@
+#pragma once
+
+#include "model.hpp"
+
+#include <cstdint>
+#include <vector>
+
+namespace nugiEngine
+{
+	// post-transform vertex cache efficiency of an index buffer, under a simulated FIFO cache
+	struct EngineVertexCacheStats {
+		float acmr = 0.0f; // average cache miss ratio: transformed vertices per triangle, 0.5 at best
+		float atvr = 0.0f; // average transformed vertex ratio: transformed vertices per vertex, 1.0 at best
+	};
+
+	/**
+	 * Reorders imported meshes for the GPU, in this order: triangles for the post-transform vertex cache
+	 * (Forsyth's linear-speed optimizer), runs of those triangles so outward facing ones are drawn first
+	 * (Sander et al.'s overdraw clustering), then vertices in order of first use for vertex fetch.
+	 * None of it changes what is drawn, only the order.
+	 */
+	class EngineMeshOptimizer
+	{
+	public:
+		// size of the FIFO cache the stats and the overdraw clustering simulate
+		static constexpr uint32_t FIFO_CACHE_SIZE = 16;
+
+		// the three stages in order; the overdraw clusters may cost up to threshold times the ACMR
+		static void optimize(std::vector<Vertex> &vertices, std::vector<uint32_t> &indices, float overdrawThreshold = 1.05f);
+
+		static void optimizeVertexCache(std::vector<uint32_t> &indices, size_t vertexCount);
+		static void optimizeOverdraw(std::vector<uint32_t> &indices, const std::vector<Vertex> &vertices, float threshold);
+		static void optimizeVertexFetch(std::vector<Vertex> &vertices, std::vector<uint32_t> &indices);
+
+		static EngineVertexCacheStats analyzeVertexCache(const std::vector<uint32_t> &indices, size_t vertexCount, uint32_t cacheSize = FIFO_CACHE_SIZE);
+	};
+} // namespace nugiEngine
@@ -1,119 +1,88 @@
 #include "model.hpp"
-#include "../utils/utils.hpp"
+#include "geometry_pool.hpp"
+#include "mesh_cache.hpp"
+#include "obj_loader.hpp"
+#include "mesh_optimizer.hpp"
 
 #include <cstring>
+#include <iomanip>
 #include <iostream>
-#include <unordered_map>
 
-#define TINYOBJLOADER_IMPLEMENTATION
-#include <tiny_obj_loader.h>
-
-#define GLM_ENABLE_EXPERIMENTAL
-#include <glm/gtx/hash.hpp>
+namespace nugiEngine {
+	EngineModel::EngineModel(EngineDevice &device, std::shared_ptr<EngineGeometryPool> geometryPool, const ModelData &datas) 
+		: engineDevice{device}, geometryPool{geometryPool} 
+	{
+		assert(datas.vertices.size() >= 3 && "Vertex count must be at least 3");
+		this->mesh = this->geometryPool->allocateMesh(datas.getMeshView());
+		EngineModel::computeBounds(datas.getMeshView(), this->boundingBox, this->boundingSphere);
+	}
 
-namespace std {
-	template<>
-	struct hash<nugiEngine::Vertex> {
-		size_t operator () (nugiEngine::Vertex const &vertex) const {
-			size_t seed = 0;
-			nugiEngine::hashCombine(seed, vertex.position, vertex.color, vertex.normal, vertex.uv);
-			return seed;
-		}
-	};
-} // namespace std
+	EngineModel::EngineModel(EngineDevice &device, std::shared_ptr<EngineGeometryPool> geometryPool, const EngineMeshView &mesh, 
+		const EngineBoundingBox &boundingBox, glm::vec4 boundingSphere) 
+		: engineDevice{device}, geometryPool{geometryPool}, boundingBox{boundingBox}, boundingSphere{boundingSphere}
+	{
+		assert(mesh.vertexCount >= 3 && "Vertex count must be at least 3");
+		this->mesh = this->geometryPool->allocateMesh(mesh);
+	}
 
-namespace nugiEngine {
-	EngineModel::EngineModel(EngineDevice &device, const ModelData &datas) : engineDevice{device} {
-		this->createVertexBuffers(datas.vertices);
-		this->createIndexBuffer(datas.indices);
+	// the pool range is reused right away, so models must only die once the GPU is done with them
+	EngineModel::~EngineModel() {
+		this->geometryPool->freeMesh(this->mesh);
 	}
 
-	EngineModel::~EngineModel() {}
+	std::unique_ptr<EngineModel> EngineModel::createModelFromFile(EngineDevice &device, std::shared_ptr<EngineGeometryPool> geometryPool, const std::string &filePath, EngineThreadPool &threadPool) {
+		// the mapped cache goes straight into the staging ring, nothing is parsed
+		if (auto meshCache = EngineMeshCache::open(filePath)) {
+			return std::make_unique<EngineModel>(device, geometryPool, meshCache->getMesh(), meshCache->getBoundingBox(), meshCache->getBoundingSphere());
+		}
 
-	std::unique_ptr<EngineModel> EngineModel::createModelFromFile(EngineDevice &device, const std::string &filePath) {
 		ModelData modelData;
-		modelData.loadModel(filePath);
+		modelData.loadModel(filePath, threadPool);
 
-		return std::make_unique<EngineModel>(device, modelData);
-	}
+		auto model = std::make_unique<EngineModel>(device, geometryPool, modelData);
+
+		// a read-only asset folder only costs the parse again next time
+		if (!EngineMeshCache::write(filePath, modelData.getMeshView(), model->getBoundingBox(), model->getBoundingSphere())) {
+			std::cerr << "could not write the mesh cache of " << filePath << "\n";
+		}
 
-	void EngineModel::createVertexBuffers(const std::vector<Vertex> &vertices) {
-		this->vertextCount = static_cast<uint32_t>(vertices.size());
-		assert(vertextCount >= 3 && "Vertex count must be at least 3");
-
-		VkDeviceSize bufferSize = sizeof(vertices[0]) * vertextCount;
-		uint32_t vertexSize = sizeof(vertices[0]);
-
-		EngineBuffer stagingBuffer {
-			this->engineDevice,
-			vertexSize,
-			this->vertextCount,
-			VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-			VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT
-		};
-
-		stagingBuffer.map();
-		stagingBuffer.writeToBuffer((void *) vertices.data());
-
-		this->vertexBuffer = std::make_unique<EngineBuffer>(
-			this->engineDevice,
-			vertexSize,
-			this->vertextCount,
-			VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
-			VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT
-		);
-
-		this->vertexBuffer->copyBuffer(stagingBuffer.getBuffer(), bufferSize);
+		return model;
 	}
 
-	void EngineModel::createIndexBuffer(const std::vector<uint32_t> &indices) { 
-		this->indexCount = static_cast<uint32_t>(indices.size());
-		this->hasIndexBuffer = this->indexCount > 0;
+	// the sphere is centered on the box; not the tightest sphere, but cheap and good enough for culling
+	void EngineModel::computeBounds(const EngineMeshView &mesh, EngineBoundingBox &boundingBox, glm::vec4 &boundingSphere) {
+		boundingBox.minPoint = mesh.vertices[0].position;
+		boundingBox.maxPoint = mesh.vertices[0].position;
 
-		if (!this->hasIndexBuffer) {
-			return;
+		for (uint32_t i = 0; i < mesh.vertexCount; i++) {
+			boundingBox.minPoint = glm::min(boundingBox.minPoint, mesh.vertices[i].position);
+			boundingBox.maxPoint = glm::max(boundingBox.maxPoint, mesh.vertices[i].position);
 		}
 
-		VkDeviceSize bufferSize = sizeof(indices[0]) * this->indexCount;
-		uint32_t indexSize = sizeof(indices[0]);
-
-		EngineBuffer stagingBuffer {
-			this->engineDevice,
-			indexSize,
-			this->indexCount,
-			VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-			VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT
-		};
-
-		stagingBuffer.map();
-		stagingBuffer.writeToBuffer((void *) indices.data());
-
-		this->indexBuffer = std::make_unique<EngineBuffer>(
-			this->engineDevice,
-			indexSize,
-			this->indexCount,
-			VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
-			VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT
-		);
-
-		this->indexBuffer->copyBuffer(stagingBuffer.getBuffer(), bufferSize);
+		glm::vec3 center = boundingBox.center();
+		float radius = 0.0f;
+
+		for (uint32_t i = 0; i < mesh.vertexCount; i++) {
+			radius = glm::max(radius, glm::length(mesh.vertices[i].position - center));
+		}
+
+		boundingSphere = glm::vec4(center, radius);
 	}
 
 	void EngineModel::bind(std::shared_ptr<EngineCommandBuffer> commandBuffer) {
-		VkBuffer buffers[] = {this->vertexBuffer->getBuffer()};
-		VkDeviceSize offsets[] = {0};
-		vkCmdBindVertexBuffers(commandBuffer->getCommandBuffer(), 0, 1, buffers, offsets);
+		this->geometryPool->bind(commandBuffer);
+	}
 
-		if (this->hasIndexBuffer) {
-			vkCmdBindIndexBuffer(commandBuffer->getCommandBuffer(), this->indexBuffer->getBuffer(), 0, VK_INDEX_TYPE_UINT32);
-		}
+	bool EngineModel::isReady() {
+		return this->engineDevice.getUploadService()->isComplete(this->mesh.uploadHandle);
 	}
 
-	void EngineModel::draw(std::shared_ptr<EngineCommandBuffer> commandBuffer) {
-		if (this->hasIndexBuffer) {
-			vkCmdDrawIndexed(commandBuffer->getCommandBuffer(), this->indexCount, 1, 0, 0, 0);
+	void EngineModel::draw(std::shared_ptr<EngineCommandBuffer> commandBuffer, uint32_t instanceCount, uint32_t firstInstance) {
+		if (this->mesh.indexCount > 0) {
+			vkCmdDrawIndexed(commandBuffer->getCommandBuffer(), this->mesh.indexCount, instanceCount, this->mesh.firstIndex, 
+				static_cast<int32_t>(this->mesh.firstVertex), firstInstance);
 		} else {
-			vkCmdDraw(commandBuffer->getCommandBuffer(), this->vertextCount, 1, 0, 0);
+			vkCmdDraw(commandBuffer->getCommandBuffer(), this->mesh.vertexCount, instanceCount, this->mesh.firstVertex, firstInstance);
 		}
 	}
 
@@ -149,61 +118,41 @@ namespace nugiEngine {
 		return attributeDescription;
 	}
 
-	void ModelData::loadModel(const std::string &filePath) {
-		tinyobj::attrib_t attrib;
-		std::vector<tinyobj::shape_t> shapes;
-		std::vector<tinyobj::material_t> materials;
-		std::string warn, err;
+	std::vector<VkVertexInputBindingDescription> InstanceData::getInstanceBindingDescriptions() {
+		std::vector<VkVertexInputBindingDescription> bindingDescriptions(1);
+		bindingDescriptions[0].binding = 1;
+		bindingDescriptions[0].stride = sizeof(InstanceData);
+		bindingDescriptions[0].inputRate = VK_VERTEX_INPUT_RATE_INSTANCE;
+		return bindingDescriptions;
+	}
 
-		if (!tinyobj::LoadObj(&attrib, &shapes, &materials, &warn, &err, filePath.c_str())) {
-			throw std::runtime_error(warn + err);
+	// a mat4 takes four consecutive locations, one per column
+	std::vector<VkVertexInputAttributeDescription> InstanceData::getInstanceAttributeDescriptions() {
+		std::vector<VkVertexInputAttributeDescription> attributeDescription(8);
+		for (uint32_t i = 0; i < 4; i++) {
+			attributeDescription[i].binding = 1;
+			attributeDescription[i].location = 4 + i;
+			attributeDescription[i].format = VK_FORMAT_R32G32B32A32_SFLOAT;
+			attributeDescription[i].offset = offsetof(InstanceData, modelMatrix) + i * sizeof(glm::vec4);
+
+			attributeDescription[4 + i].binding = 1;
+			attributeDescription[4 + i].location = 8 + i;
+			attributeDescription[4 + i].format = VK_FORMAT_R32G32B32A32_SFLOAT;
+			attributeDescription[4 + i].offset = offsetof(InstanceData, normalMatrix) + i * sizeof(glm::vec4);
 		}
+		
+		return attributeDescription;
+	}
 
-		this->vertices.clear();
-		this->indices.clear();
-
-		std::unordered_map<Vertex, uint32_t> uniqueVertices{};
-		for (const auto &shape: shapes) {
-			for (const auto &index: shape.mesh.indices) {
-				Vertex vertex{};
-
-				if (index.vertex_index >= 0) {
-					vertex.position = {
-						attrib.vertices[3 * index.vertex_index + 0],
-						attrib.vertices[3 * index.vertex_index + 1],
-						attrib.vertices[3 * index.vertex_index + 2]
-					};
-
-					vertex.color = {
-						attrib.colors[3 * index.vertex_index + 0],
-						attrib.colors[3 * index.vertex_index + 1],
-						attrib.colors[3 * index.vertex_index + 2]
-					};
-				}
-
-				if (index.normal_index >= 0) {
-					vertex.normal = {
-						attrib.normals[3 * index.normal_index + 0],
-						attrib.normals[3 * index.normal_index + 1],
-						attrib.normals[3 * index.normal_index + 2]
-					};
-				}
-
-				if (index.texcoord_index >= 0) {
-					vertex.uv = { // temoirary. for OBJ object only
-						attrib.texcoords[2 * index.texcoord_index + 0],
-    				1.0f - attrib.texcoords[2 * index.texcoord_index + 1]
-					};
-				}
-
-				if (uniqueVertices.count(vertex) == 0) {
-					uniqueVertices[vertex] = static_cast<uint32_t>(this->vertices.size());
-					this->vertices.push_back(vertex);
-				}
-
-				this->indices.push_back(uniqueVertices[vertex]);
-			}
-		}
+	void ModelData::loadModel(const std::string &filePath, EngineThreadPool &threadPool) {
+		EngineObjLoader::load(filePath, threadPool, this->vertices, this->indices);
+
+		auto beforeStats = EngineMeshOptimizer::analyzeVertexCache(this->indices, this->vertices.size());
+		EngineMeshOptimizer::optimize(this->vertices, this->indices);
+		auto afterStats = EngineMeshOptimizer::analyzeVertexCache(this->indices, this->vertices.size());
+
+		std::cout << std::fixed << std::setprecision(3) << filePath << ": ACMR " << beforeStats.acmr << " -> " << afterStats.acmr
+			<< ", ATVR " << beforeStats.atvr << " -> " << afterStats.atvr << std::defaultfloat << '\n';
 	}
     
 } // namespace nugiEngine
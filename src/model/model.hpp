@@ -3,6 +3,8 @@
 #include "../device/device.hpp"
 #include "../buffer/buffer.hpp"
 #include "../command/command_buffer.hpp"
+#include "../upload/upload_service.hpp"
+#include "../thread/thread_pool.hpp"
 
 #define GLM_FORCE_RADIANS
 #define GLM_FORCE_DEPTH_ZERO_TO_ONE
@@ -28,40 +30,90 @@ namespace nugiEngine
 		}
 	};
 
+	// per-instance attributes, read from a second vertex binding at VK_VERTEX_INPUT_RATE_INSTANCE
+	struct InstanceData {
+		glm::mat4 modelMatrix{1.0f};
+		glm::mat4 normalMatrix{1.0f};
+
+		static std::vector<VkVertexInputBindingDescription> getInstanceBindingDescriptions();
+		static std::vector<VkVertexInputAttributeDescription> getInstanceAttributeDescriptions();
+	};
+
+	struct EngineBoundingBox {
+		glm::vec3 minPoint{0.0f};
+		glm::vec3 maxPoint{0.0f};
+
+		glm::vec3 center() const { return (this->minPoint + this->maxPoint) * 0.5f; }
+		glm::vec3 extents() const { return (this->maxPoint - this->minPoint) * 0.5f; }
+	};
+
+	class EngineGeometryPool;
+
+	// where a mesh lives inside an EngineGeometryPool
+	struct EngineMeshAllocation {
+		uint32_t firstVertex = 0;
+		uint32_t vertexCount = 0;
+		uint32_t firstIndex = 0;
+		uint32_t indexCount = 0;
+		EngineUploadHandle uploadHandle;
+	};
+
+	// final vertices & indices of a mesh in memory owned by someone else, e.g. a mapped mesh cache
+	struct EngineMeshView {
+		const Vertex* vertices = nullptr;
+		uint32_t vertexCount = 0;
+		const uint32_t* indices = nullptr;
+		uint32_t indexCount = 0;
+	};
+
 	struct ModelData
 	{
 		std::vector<Vertex> vertices{};
 		std::vector<uint32_t> indices{};
 
-		void loadModel(const std::string &filePath);
+		// parses an OBJ file with the thread pool, then reorders it for the vertex cache, overdraw & vertex fetch
+		void loadModel(const std::string &filePath, EngineThreadPool &threadPool);
+
+		EngineMeshView getMeshView() const {
+			return EngineMeshView{ this->vertices.data(), static_cast<uint32_t>(this->vertices.size()), this->indices.data(), static_cast<uint32_t>(this->indices.size()) };
+		}
 	};
 
 	class EngineModel
 	{
 	public:
-		EngineModel(EngineDevice &device, const ModelData &data);
+		EngineModel(EngineDevice &device, std::shared_ptr<EngineGeometryPool> geometryPool, const ModelData &data);
+		EngineModel(EngineDevice &device, std::shared_ptr<EngineGeometryPool> geometryPool, const EngineMeshView &mesh, 
+			const EngineBoundingBox &boundingBox, glm::vec4 boundingSphere);
 		~EngineModel();
 
 		EngineModel(const EngineModel&) = delete;
 		EngineModel& operator = (const EngineModel&) = delete;
 
-		static std::unique_ptr<EngineModel> createModelFromFile(EngineDevice &device, const std::string &filePath);
+		// loads filePath's mesh cache when it is up to date, otherwise parses the file and writes the cache
+		static std::unique_ptr<EngineModel> createModelFromFile(EngineDevice &device, std::shared_ptr<EngineGeometryPool> geometryPool, const std::string &filePath, EngineThreadPool &threadPool);
+
+		EngineGeometryPool* getGeometryPool() const { return this->geometryPool.get(); }
+		const EngineMeshAllocation& getMesh() const { return this->mesh; }
+
+		// model space bounds, computed once when the model is created
+		const EngineBoundingBox& getBoundingBox() const { return this->boundingBox; }
+		glm::vec4 getBoundingSphere() const { return this->boundingSphere; } // center in xyz, radius in w
+
+		static void computeBounds(const EngineMeshView &mesh, EngineBoundingBox &boundingBox, glm::vec4 &boundingSphere);
 
+		// binds the whole geometry pool; only needed when the previous model came from another pool
 		void bind(std::shared_ptr<EngineCommandBuffer> commandBuffer);
-		void draw(std::shared_ptr<EngineCommandBuffer> commandBuffer);
+		void draw(std::shared_ptr<EngineCommandBuffer> commandBuffer, uint32_t instanceCount = 1, uint32_t firstInstance = 0);
+
+		// false until the vertex & index upload has landed on the graphics queue
+		bool isReady();
 		
 	private:
 		EngineDevice &engineDevice;
-		
-		std::unique_ptr<EngineBuffer> vertexBuffer;
-		uint32_t vertextCount;
-
-		std::unique_ptr<EngineBuffer> indexBuffer;
-		uint32_t indexCount;
-
-		bool hasIndexBuffer = false;
-
-		void createVertexBuffers(const std::vector<Vertex> &vertices);
-		void createIndexBuffer(const std::vector<uint32_t> &indices);
+		std::shared_ptr<EngineGeometryPool> geometryPool;
+		EngineMeshAllocation mesh;
+		EngineBoundingBox boundingBox{};
+		glm::vec4 boundingSphere{0.0f};
 	};
 } // namespace nugiEngine
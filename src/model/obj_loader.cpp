@@ -0,0 +1,525 @@
+#include "obj_loader.hpp"
+#include "vertex_dedup.hpp"
+#include "../utils/mapped_file.hpp"
+
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+
+namespace nugiEngine {
+	namespace {
+		// fixed, so the chunking & with it the output order is the same on every machine
+		constexpr size_t OBJ_CHUNK_SIZE = 4 << 20;
+
+		// the top bits of the vertex hash pick the shard, the tables probe with the low bits
+		constexpr uint32_t OBJ_DEDUP_SHARD_BITS = 6;
+		constexpr uint32_t OBJ_DEDUP_SHARD_COUNT = 1u << OBJ_DEDUP_SHARD_BITS;
+
+		constexpr int32_t OBJ_ABSENT_INDEX = INT32_MIN;
+
+		constexpr uint8_t OBJ_RELATIVE_POSITION = 1 << 0;
+		constexpr uint8_t OBJ_RELATIVE_TEXCOORD = 1 << 1;
+		constexpr uint8_t OBJ_RELATIVE_NORMAL = 1 << 2;
+
+		// zero based attribute indices of a face corner. Negative OBJ indices count back from the
+		// attributes read so far, they are kept relative to the chunk until the chunk bases are known
+		struct ObjCorner {
+			int32_t position = OBJ_ABSENT_INDEX;
+			int32_t texcoord = OBJ_ABSENT_INDEX;
+			int32_t normal = OBJ_ABSENT_INDEX;
+			uint8_t relativeMask = 0;
+		};
+
+		struct ObjChunk {
+			const char* begin = nullptr;
+			const char* end = nullptr;
+
+			// parsed attributes, moved into the file wide arrays once the bases are known
+			std::vector<float> positions, colors, normals, texcoords;
+			std::vector<ObjCorner> corners; // three per triangle
+
+			uint32_t positionBase = 0, normalBase = 0, texcoordBase = 0;
+
+			// chunk unique vertices & the chunk's indices into them
+			std::vector<Vertex> vertices;
+			std::vector<uint32_t> indices;
+
+			// per chunk vertex: its dedup shard, its id inside the shard & whether this chunk saw it first
+			std::vector<uint8_t> vertexShards;
+			std::vector<uint32_t> shardIds;
+			std::vector<uint8_t> isOwned;
+			std::vector<uint32_t> shardVertices[OBJ_DEDUP_SHARD_COUNT];
+
+			uint32_t vertexBase = 0;
+			size_t indexBase = 0;
+
+			std::string error;
+		};
+
+		bool isLineSpace(char c) {
+			return c == ' ' || c == '\t' || c == '\r';
+		}
+
+		void skipSpaces(const char* &cursor, const char* end) {
+			while (cursor < end && isLineSpace(*cursor)) cursor++;
+		}
+
+		bool parseFloat(const char* &cursor, const char* end, float &value) {
+			static const double powersOfTen[] = {
+				1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+				1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+			};
+
+			skipSpaces(cursor, end);
+			const char* p = cursor;
+
+			bool isNegative = false;
+			if (p < end && (*p == '-' || *p == '+')) {
+				isNegative = *p == '-';
+				p++;
+			}
+
+			// up to 19 significant digits fit in the mantissa, the rest only shifts the exponent
+			uint64_t mantissa = 0;
+			int32_t exponent = 0, digitCount = 0, significantCount = 0;
+
+			for (; p < end && *p >= '0' && *p <= '9'; p++, digitCount++) {
+				if (significantCount < 19) {
+					mantissa = mantissa * 10 + static_cast<uint64_t>(*p - '0');
+					if (mantissa > 0) significantCount++;
+				} else {
+					exponent++;
+				}
+			}
+
+			if (p < end && *p == '.') {
+				for (p++; p < end && *p >= '0' && *p <= '9'; p++, digitCount++) {
+					if (significantCount < 19) {
+						mantissa = mantissa * 10 + static_cast<uint64_t>(*p - '0');
+						if (mantissa > 0) significantCount++;
+						exponent--;
+					}
+				}
+			}
+
+			if (digitCount == 0) return false;
+
+			if (p < end && (*p == 'e' || *p == 'E')) {
+				const char* exponentStart = p++;
+
+				bool isExponentNegative = false;
+				if (p < end && (*p == '-' || *p == '+')) {
+					isExponentNegative = *p == '-';
+					p++;
+				}
+
+				if (p < end && *p >= '0' && *p <= '9') {
+					int32_t exponentValue = 0;
+					for (; p < end && *p >= '0' && *p <= '9'; p++) {
+						exponentValue = std::min(exponentValue * 10 + (*p - '0'), 9999);
+					}
+
+					exponent += isExponentNegative ? -exponentValue : exponentValue;
+				} else {
+					p = exponentStart;
+				}
+			}
+
+			// exact for mantissas below 2^53 and exponents within the table, which covers OBJ files in practice
+			double result = static_cast<double>(mantissa);
+			if (exponent < 0) {
+				result = exponent >= -22 ? result / powersOfTen[-exponent] : result * std::pow(10.0, exponent);
+			} else if (exponent > 0) {
+				result = exponent <= 22 ? result * powersOfTen[exponent] : result * std::pow(10.0, exponent);
+			}
+
+			value = static_cast<float>(isNegative ? -result : result);
+			cursor = p;
+
+			return true;
+		}
+
+		bool parseInt(const char* &cursor, const char* end, int64_t &value) {
+			const char* p = cursor;
+
+			bool isNegative = false;
+			if (p < end && (*p == '-' || *p == '+')) {
+				isNegative = *p == '-';
+				p++;
+			}
+
+			if (p == end || *p < '0' || *p > '9') return false;
+
+			int64_t result = 0;
+			for (; p < end && *p >= '0' && *p <= '9'; p++) {
+				result = std::min<int64_t>(result * 10 + (*p - '0'), INT32_MAX);
+			}
+
+			value = isNegative ? -result : result;
+			cursor = p;
+
+			return true;
+		}
+
+		// OBJ indices start at 1, negative ones count back from the current attribute count
+		bool resolveIndex(int64_t objIndex, size_t localCount, uint8_t relativeBit, int32_t &index, uint8_t &relativeMask) {
+			if (objIndex > 0) {
+				index = static_cast<int32_t>(objIndex - 1);
+				return true;
+			}
+
+			if (objIndex < 0) {
+				index = static_cast<int32_t>(static_cast<int64_t>(localCount) + objIndex);
+				relativeMask |= relativeBit;
+				return true;
+			}
+
+			return false;
+		}
+
+		// v, v/vt, v//vn or v/vt/vn
+		bool parseCorner(const char* &cursor, const char* end, const ObjChunk &chunk, ObjCorner &corner) {
+			int64_t objIndex = 0;
+
+			if (!parseInt(cursor, end, objIndex) || !resolveIndex(objIndex, chunk.positions.size() / 3, OBJ_RELATIVE_POSITION, corner.position, corner.relativeMask)) {
+				return false;
+			}
+
+			if (cursor == end || *cursor != '/') return true;
+			cursor++;
+
+			if (cursor < end && *cursor != '/') {
+				if (!parseInt(cursor, end, objIndex) || !resolveIndex(objIndex, chunk.texcoords.size() / 2, OBJ_RELATIVE_TEXCOORD, corner.texcoord, corner.relativeMask)) {
+					return false;
+				}
+			}
+
+			if (cursor == end || *cursor != '/') return true;
+			cursor++;
+
+			return parseInt(cursor, end, objIndex) && resolveIndex(objIndex, chunk.normals.size() / 3, OBJ_RELATIVE_NORMAL, corner.normal, corner.relativeMask);
+		}
+
+		bool parseLine(const char* cursor, const char* end, ObjChunk &chunk) {
+			skipSpaces(cursor, end);
+
+			const char* keyword = cursor;
+			while (cursor < end && !isLineSpace(*cursor)) cursor++;
+
+			const size_t keywordLength = static_cast<size_t>(cursor - keyword);
+			auto isKeyword = [keyword, keywordLength](const char* name) {
+				return std::strlen(name) == keywordLength && std::memcmp(keyword, name, keywordLength) == 0;
+			};
+
+			float values[6];
+
+			// everything else (comments, groups, materials, ...) carries no geometry
+			if (isKeyword("vn")) {
+				if (!parseFloat(cursor, end, values[0]) || !parseFloat(cursor, end, values[1]) || !parseFloat(cursor, end, values[2])) return false;
+
+				chunk.normals.insert(chunk.normals.end(), values, values + 3);
+			} else if (isKeyword("vt")) {
+				if (!parseFloat(cursor, end, values[0]) || !parseFloat(cursor, end, values[1])) return false;
+
+				chunk.texcoords.insert(chunk.texcoords.end(), values, values + 2);
+			} else if (isKeyword("v")) {
+				if (!parseFloat(cursor, end, values[0]) || !parseFloat(cursor, end, values[1]) || !parseFloat(cursor, end, values[2])) return false;
+
+				// optional vertex color, white without one
+				if (!parseFloat(cursor, end, values[3]) || !parseFloat(cursor, end, values[4]) || !parseFloat(cursor, end, values[5])) {
+					values[3] = values[4] = values[5] = 1.0f;
+				}
+
+				chunk.positions.insert(chunk.positions.end(), values, values + 3);
+				chunk.colors.insert(chunk.colors.end(), values + 3, values + 6);
+			} else if (isKeyword("f")) {
+				ObjCorner first{}, previous{};
+				uint32_t cornerCount = 0;
+
+				for (skipSpaces(cursor, end); cursor < end && *cursor != '#'; skipSpaces(cursor, end)) {
+					ObjCorner corner{};
+					if (!parseCorner(cursor, end, chunk, corner)) return false;
+
+					// fan around the first corner
+					if (cornerCount >= 2) {
+						chunk.corners.push_back(first);
+						chunk.corners.push_back(previous);
+						chunk.corners.push_back(corner);
+					}
+
+					if (cornerCount == 0) first = corner;
+					previous = corner;
+					cornerCount++;
+				}
+			}
+
+			return true;
+		}
+
+		void parseChunk(ObjChunk &chunk) {
+			for (const char* lineStart = chunk.begin; lineStart < chunk.end; ) {
+				const char* lineEnd = static_cast<const char*>(std::memchr(lineStart, '\n', static_cast<size_t>(chunk.end - lineStart)));
+				if (lineEnd == nullptr) lineEnd = chunk.end;
+
+				if (!parseLine(lineStart, lineEnd, chunk)) {
+					chunk.error = "malformed line: " + std::string(lineStart, lineEnd);
+					return;
+				}
+
+				lineStart = lineEnd + 1;
+			}
+		}
+
+		bool resolveCorner(const ObjCorner &corner, uint8_t relativeBit, int32_t index, uint32_t base, uint32_t count, uint32_t &result) {
+			int64_t absoluteIndex = static_cast<int64_t>(index) + ((corner.relativeMask & relativeBit) ? base : 0);
+			if (absoluteIndex < 0 || absoluteIndex >= count) return false;
+
+			result = static_cast<uint32_t>(absoluteIndex);
+			return true;
+		}
+
+		struct ObjAttributes {
+			std::vector<float> positions, colors, normals, texcoords;
+		};
+
+		void assembleChunk(ObjChunk &chunk, const ObjAttributes &attributes) {
+			const uint32_t positionCount = static_cast<uint32_t>(attributes.positions.size() / 3);
+			const uint32_t normalCount = static_cast<uint32_t>(attributes.normals.size() / 3);
+			const uint32_t texcoordCount = static_cast<uint32_t>(attributes.texcoords.size() / 2);
+
+			chunk.indices.reserve(chunk.corners.size());
+			EngineVertexDedupTable uniqueVertices{chunk.vertices, chunk.corners.size()};
+
+			for (const auto &corner : chunk.corners) {
+				Vertex vertex{};
+				uint32_t index = 0;
+
+				if (!resolveCorner(corner, OBJ_RELATIVE_POSITION, corner.position, chunk.positionBase, positionCount, index)) {
+					chunk.error = "vertex index out of range";
+					return;
+				}
+
+				// offsets in size_t, three times a valid index can pass 2^32
+				size_t offset = 3 * static_cast<size_t>(index);
+				vertex.position = { attributes.positions[offset + 0], attributes.positions[offset + 1], attributes.positions[offset + 2] };
+				vertex.color = { attributes.colors[offset + 0], attributes.colors[offset + 1], attributes.colors[offset + 2] };
+
+				if (corner.normal != OBJ_ABSENT_INDEX) {
+					if (!resolveCorner(corner, OBJ_RELATIVE_NORMAL, corner.normal, chunk.normalBase, normalCount, index)) {
+						chunk.error = "normal index out of range";
+						return;
+					}
+
+					offset = 3 * static_cast<size_t>(index);
+					vertex.normal = { attributes.normals[offset + 0], attributes.normals[offset + 1], attributes.normals[offset + 2] };
+				}
+
+				if (corner.texcoord != OBJ_ABSENT_INDEX) {
+					if (!resolveCorner(corner, OBJ_RELATIVE_TEXCOORD, corner.texcoord, chunk.texcoordBase, texcoordCount, index)) {
+						chunk.error = "texture coordinate index out of range";
+						return;
+					}
+
+					offset = 2 * static_cast<size_t>(index);
+					vertex.uv = { attributes.texcoords[offset + 0], 1.0f - attributes.texcoords[offset + 1] };
+				}
+
+				chunk.indices.push_back(uniqueVertices.insertOrGet(vertex));
+			}
+
+			std::vector<ObjCorner>().swap(chunk.corners);
+		}
+
+		void throwChunkErrors(const std::vector<ObjChunk> &chunks, const std::string &filePath) {
+			for (const auto &chunk : chunks) {
+				if (!chunk.error.empty()) {
+					throw std::runtime_error("failed to load " + filePath + ": " + chunk.error);
+				}
+			}
+		}
+	}
+
+	void EngineObjLoader::load(const std::string &filePath, EngineThreadPool &threadPool, std::vector<Vertex> &vertices, std::vector<uint32_t> &indices) {
+		auto file = EngineMappedFile::open(filePath);
+		if (file == nullptr) {
+			throw std::runtime_error("failed to open " + filePath);
+		}
+
+		vertices.clear();
+		indices.clear();
+
+		// every chunk but the first starts right after the first line break past its nominal offset
+		const char* fileBegin = reinterpret_cast<const char*>(file->getData());
+		const char* fileEnd = fileBegin + file->getSize();
+
+		std::vector<ObjChunk> chunks;
+		for (const char* chunkBegin = fileBegin; chunkBegin < fileEnd; ) {
+			const char* chunkEnd = fileEnd;
+
+			if (static_cast<size_t>(fileEnd - chunkBegin) > OBJ_CHUNK_SIZE) {
+				const char* lineBreak = static_cast<const char*>(std::memchr(chunkBegin + OBJ_CHUNK_SIZE, '\n', static_cast<size_t>(fileEnd - chunkBegin - OBJ_CHUNK_SIZE)));
+				if (lineBreak != nullptr) chunkEnd = lineBreak + 1;
+			}
+
+			chunks.emplace_back();
+			chunks.back().begin = chunkBegin;
+			chunks.back().end = chunkEnd;
+
+			chunkBegin = chunkEnd;
+		}
+
+		const uint32_t chunkCount = static_cast<uint32_t>(chunks.size());
+
+		threadPool.parallelFor(chunkCount, 1, [&chunks](uint32_t begin, uint32_t end, uint32_t threadIndex) {
+			for (uint32_t i = begin; i < end; i++) {
+				parseChunk(chunks[i]);
+			}
+		});
+
+		throwChunkErrors(chunks, filePath);
+
+		// attribute bases resolve the relative indices and place each chunk in the file wide arrays
+		size_t positionCount = 0, normalCount = 0, texcoordCount = 0;
+		for (auto &chunk : chunks) {
+			chunk.positionBase = static_cast<uint32_t>(positionCount);
+			chunk.normalBase = static_cast<uint32_t>(normalCount);
+			chunk.texcoordBase = static_cast<uint32_t>(texcoordCount);
+
+			positionCount += chunk.positions.size() / 3;
+			normalCount += chunk.normals.size() / 3;
+			texcoordCount += chunk.texcoords.size() / 2;
+		}
+
+		if (positionCount > INT32_MAX || normalCount > INT32_MAX || texcoordCount > INT32_MAX) {
+			throw std::runtime_error("failed to load " + filePath + ": too many vertex attributes");
+		}
+
+		ObjAttributes attributes;
+		attributes.positions.resize(positionCount * 3);
+		attributes.colors.resize(positionCount * 3);
+		attributes.normals.resize(normalCount * 3);
+		attributes.texcoords.resize(texcoordCount * 2);
+
+		threadPool.parallelFor(chunkCount, 1, [&chunks, &attributes](uint32_t begin, uint32_t end, uint32_t threadIndex) {
+			for (uint32_t i = begin; i < end; i++) {
+				auto &chunk = chunks[i];
+
+				std::copy(chunk.positions.begin(), chunk.positions.end(), attributes.positions.begin() + 3 * static_cast<size_t>(chunk.positionBase));
+				std::copy(chunk.colors.begin(), chunk.colors.end(), attributes.colors.begin() + 3 * static_cast<size_t>(chunk.positionBase));
+				std::copy(chunk.normals.begin(), chunk.normals.end(), attributes.normals.begin() + 3 * static_cast<size_t>(chunk.normalBase));
+				std::copy(chunk.texcoords.begin(), chunk.texcoords.end(), attributes.texcoords.begin() + 2 * static_cast<size_t>(chunk.texcoordBase));
+
+				std::vector<float>().swap(chunk.positions);
+				std::vector<float>().swap(chunk.colors);
+				std::vector<float>().swap(chunk.normals);
+				std::vector<float>().swap(chunk.texcoords);
+			}
+		});
+
+		// builds each chunk's vertices & indices, then sorts its vertices into the dedup shards
+		threadPool.parallelFor(chunkCount, 1, [&chunks, &attributes](uint32_t begin, uint32_t end, uint32_t threadIndex) {
+			for (uint32_t i = begin; i < end; i++) {
+				auto &chunk = chunks[i];
+
+				assembleChunk(chunk, attributes);
+				if (!chunk.error.empty()) continue;
+
+				const uint32_t vertexCount = static_cast<uint32_t>(chunk.vertices.size());
+				chunk.vertexShards.resize(vertexCount);
+				chunk.shardIds.resize(vertexCount);
+				chunk.isOwned.assign(vertexCount, 0);
+
+				for (uint32_t v = 0; v < vertexCount; v++) {
+					uint8_t shard = static_cast<uint8_t>(EngineVertexDedupTable::hashVertex(chunk.vertices[v]) >> (64 - OBJ_DEDUP_SHARD_BITS));
+
+					chunk.vertexShards[v] = shard;
+					chunk.shardVertices[shard].push_back(v);
+				}
+			}
+		});
+
+		throwChunkErrors(chunks, filePath);
+		attributes = ObjAttributes{};
+
+		// a vertex is owned by the first chunk that uses it, chunks go through every shard in file order
+		std::vector<std::vector<uint32_t>> shardGlobalIndices(OBJ_DEDUP_SHARD_COUNT);
+
+		threadPool.parallelFor(OBJ_DEDUP_SHARD_COUNT, 1, [&chunks, &shardGlobalIndices](uint32_t begin, uint32_t end, uint32_t threadIndex) {
+			for (uint32_t shard = begin; shard < end; shard++) {
+				size_t candidateCount = 0;
+				for (const auto &chunk : chunks) {
+					candidateCount += chunk.shardVertices[shard].size();
+				}
+
+				std::vector<Vertex> shardVertices;
+				shardVertices.reserve(candidateCount);
+				EngineVertexDedupTable uniqueVertices{shardVertices, candidateCount};
+
+				for (auto &chunk : chunks) {
+					for (uint32_t v : chunk.shardVertices[shard]) {
+						size_t shardVertexCount = shardVertices.size();
+						chunk.shardIds[v] = uniqueVertices.insertOrGet(chunk.vertices[v]);
+
+						if (shardVertices.size() > shardVertexCount) {
+							chunk.isOwned[v] = 1;
+						}
+					}
+
+					std::vector<uint32_t>().swap(chunk.shardVertices[shard]);
+				}
+
+				shardGlobalIndices[shard].resize(shardVertices.size());
+			}
+		});
+
+		// owned vertices in chunk order are the vertices in order of first use
+		size_t vertexCount = 0, indexCount = 0;
+		for (auto &chunk : chunks) {
+			chunk.vertexBase = static_cast<uint32_t>(vertexCount);
+			chunk.indexBase = indexCount;
+
+			vertexCount += static_cast<size_t>(std::count(chunk.isOwned.begin(), chunk.isOwned.end(), 1));
+			indexCount += chunk.indices.size();
+
+			if (vertexCount > UINT32_MAX) {
+				throw std::runtime_error("failed to load " + filePath + ": too many vertices");
+			}
+		}
+
+		vertices.resize(vertexCount);
+		indices.resize(indexCount);
+
+		threadPool.parallelFor(chunkCount, 1, [&chunks, &shardGlobalIndices, &vertices](uint32_t begin, uint32_t end, uint32_t threadIndex) {
+			for (uint32_t i = begin; i < end; i++) {
+				auto &chunk = chunks[i];
+				uint32_t globalIndex = chunk.vertexBase;
+
+				for (uint32_t v = 0; v < chunk.vertices.size(); v++) {
+					if (!chunk.isOwned[v]) continue;
+
+					vertices[globalIndex] = chunk.vertices[v];
+					shardGlobalIndices[chunk.vertexShards[v]][chunk.shardIds[v]] = globalIndex++;
+				}
+			}
+		});
+
+		threadPool.parallelFor(chunkCount, 1, [&chunks, &shardGlobalIndices, &indices](uint32_t begin, uint32_t end, uint32_t threadIndex) {
+			for (uint32_t i = begin; i < end; i++) {
+				auto &chunk = chunks[i];
+
+				// the chunk's vertex ids become file wide ones
+				for (uint32_t v = 0; v < chunk.vertices.size(); v++) {
+					chunk.shardIds[v] = shardGlobalIndices[chunk.vertexShards[v]][chunk.shardIds[v]];
+				}
+
+				for (size_t j = 0; j < chunk.indices.size(); j++) {
+					indices[chunk.indexBase + j] = chunk.shardIds[chunk.indices[j]];
+				}
+
+				chunk = ObjChunk{};
+			}
+		});
+	}
+} // namespace nugiEngine
@@ -0,0 +1,25 @@
+#pragma once
+
+#include "model.hpp"
+#include "../thread/thread_pool.hpp"
+
+#include <string>
+#include <vector>
+
+namespace nugiEngine
+{
+	/**
+	 * Wavefront OBJ geometry import spread over the thread pool. The mapped file is cut into fixed size
+	 * chunks on line boundaries; every chunk is parsed, assembled into vertices and deduplicated on its
+	 * own, then the chunks are merged by a dedup pass sharded by vertex hash. Only v, vn, vt & f lines are
+	 * read, polygons are fanned into triangles. The result does not depend on the thread count: vertices
+	 * come out in order of first use, as a single threaded loader would give them.
+	 */
+	class EngineObjLoader
+	{
+	public:
+		// throws std::runtime_error when the file cannot be opened or is malformed; what a worker throws,
+		// e.g. std::bad_alloc, reaches the caller through the thread pool
+		static void load(const std::string &filePath, EngineThreadPool &threadPool, std::vector<Vertex> &vertices, std::vector<uint32_t> &indices);
+	};
+} // namespace nugiEngine
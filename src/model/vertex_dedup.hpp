@@ -0,0 +1,116 @@
+#pragma once
+
+#include "model.hpp"
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace nugiEngine
+{
+	// the table hashes & compares vertices as raw bytes, so they must not have padding
+	static_assert(sizeof(Vertex) == 11 * sizeof(float), "Vertex must be tightly packed");
+
+	/**
+	 * Flat open-addressing table mapping vertices to their index in an output vertex array. Slots only
+	 * hold the index and the hash, the vertex itself is compared against the output array. Vertices are
+	 * compared bytewise, so 0.0 and -0.0 count as different vertices; that only costs a duplicate.
+	 */
+	class EngineVertexDedupTable
+	{
+	public:
+		// expectedCount is an upper bound like the index count; a mesh has far fewer unique vertices than
+		// corners, so the table starts at that size and only grow() keeps it under half load otherwise
+		EngineVertexDedupTable(std::vector<Vertex> &vertices, size_t expectedCount) : vertices{vertices} {
+			size_t capacity = 16;
+			while (capacity < expectedCount) capacity <<= 1;
+
+			this->slots.assign(capacity, Slot{});
+			this->mask = capacity - 1;
+		}
+
+		// one probe sequence: returns the index of an equal vertex, or appends this one and returns its index
+		uint32_t insertOrGet(const Vertex &vertex) {
+			uint64_t hash = EngineVertexDedupTable::hashVertex(vertex);
+			uint32_t shortHash = static_cast<uint32_t>(hash >> 32);
+
+			for (size_t slotIndex = hash & this->mask; ; slotIndex = (slotIndex + 1) & this->mask) {
+				Slot &slot = this->slots[slotIndex];
+
+				if (slot.index == INVALID_INDEX) {
+					uint32_t index = static_cast<uint32_t>(this->vertices.size());
+					this->vertices.push_back(vertex);
+
+					slot.hash = shortHash;
+					slot.index = index;
+
+					if (++this->count * 2 > this->slots.size()) {
+						this->grow();
+					}
+
+					return index;
+				}
+
+				if (slot.hash == shortHash && std::memcmp(&this->vertices[slot.index], &vertex, sizeof(Vertex)) == 0) {
+					return slot.index;
+				}
+			}
+		}
+
+		static uint64_t hashVertex(const Vertex &vertex) {
+			const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&vertex);
+			uint64_t hash = 0x9E3779B97F4A7C15ull;
+
+			// five 8 byte words and the last 4 bytes
+			for (size_t offset = 0; offset + sizeof(uint64_t) <= sizeof(Vertex); offset += sizeof(uint64_t)) {
+				uint64_t word;
+				std::memcpy(&word, bytes + offset, sizeof(uint64_t));
+
+				hash = (hash ^ word) * 0xFF51AFD7ED558CCDull;
+				hash ^= hash >> 32;
+			}
+
+			uint32_t tail;
+			std::memcpy(&tail, bytes + sizeof(Vertex) - sizeof(uint32_t), sizeof(uint32_t));
+
+			hash = (hash ^ tail) * 0xC4CEB9FE1A85EC53ull;
+			hash ^= hash >> 29;
+
+			return hash;
+		}
+
+	private:
+		static constexpr uint32_t INVALID_INDEX = 0xFFFFFFFF;
+
+		struct Slot {
+			uint32_t hash = 0;
+			uint32_t index = INVALID_INDEX;
+		};
+
+		// only when the reserve was too small; the stored indices are rehashed from the output vertices
+		void grow() {
+			std::vector<Slot> oldSlots = std::move(this->slots);
+
+			this->slots.assign(oldSlots.size() * 2, Slot{});
+			this->mask = this->slots.size() - 1;
+
+			for (const Slot &oldSlot : oldSlots) {
+				if (oldSlot.index == INVALID_INDEX) continue;
+
+				uint64_t hash = EngineVertexDedupTable::hashVertex(this->vertices[oldSlot.index]);
+				size_t slotIndex = hash & this->mask;
+
+				while (this->slots[slotIndex].index != INVALID_INDEX) {
+					slotIndex = (slotIndex + 1) & this->mask;
+				}
+
+				this->slots[slotIndex] = oldSlot;
+			}
+		}
+
+		std::vector<Vertex> &vertices;
+		std::vector<Slot> slots;
+		size_t mask = 0;
+		size_t count = 0;
+	};
+} // namespace nugiEngine
@@ -0,0 +1,48 @@
+#include "compute_pipeline.hpp"
+#include "pipeline.hpp"
+
+#include <stdexcept>
+
+namespace nugiEngine {
+	EngineComputePipeline::EngineComputePipeline(EngineDevice& device, VkPipelineLayout pipelineLayout, const std::string& compFilePath) : engineDevice{device} {
+		this->createComputePipeline(pipelineLayout, compFilePath);
+	}
+
+	EngineComputePipeline::~EngineComputePipeline() {
+		vkDestroyShaderModule(this->engineDevice.getLogicalDevice(), this->shaderModule, nullptr);
+		vkDestroyPipeline(this->engineDevice.getLogicalDevice(), this->computePipeline, nullptr);
+	}
+
+	void EngineComputePipeline::createComputePipeline(VkPipelineLayout pipelineLayout, const std::string& compFilePath) {
+		auto compCode = EnginePipeline::readFile(compFilePath);
+		EnginePipeline::createShaderModule(this->engineDevice, compCode, &this->shaderModule);
+
+		VkPipelineShaderStageCreateInfo computeShaderStageInfo{};
+		computeShaderStageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+		computeShaderStageInfo.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+		computeShaderStageInfo.module = this->shaderModule;
+		computeShaderStageInfo.pName = "main";
+		computeShaderStageInfo.flags = 0;
+		computeShaderStageInfo.pNext = nullptr;
+		computeShaderStageInfo.pSpecializationInfo = nullptr;
+
+		VkComputePipelineCreateInfo pipelineInfo{};
+		pipelineInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+		pipelineInfo.stage = computeShaderStageInfo;
+		pipelineInfo.layout = pipelineLayout;
+		pipelineInfo.basePipelineIndex = -1;
+		pipelineInfo.basePipelineHandle = VK_NULL_HANDLE;
+
+		if (vkCreateComputePipelines(this->engineDevice.getLogicalDevice(), this->engineDevice.getPipelineCache(), 1, &pipelineInfo, nullptr, &this->computePipeline) != VK_SUCCESS) {
+			throw std::runtime_error("failed to create compute pipelines");
+		}
+	}
+
+	void EngineComputePipeline::bind(VkCommandBuffer commandBuffer) {
+		vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, this->computePipeline);
+	}
+
+	void EngineComputePipeline::dispatch(VkCommandBuffer commandBuffer, uint32_t groupCountX, uint32_t groupCountY, uint32_t groupCountZ) {
+		vkCmdDispatch(commandBuffer, groupCountX, groupCountY, groupCountZ);
+	}
+} // namespace nugiEngine
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <memory>
+
+#include "../device/device.hpp"
+
+namespace nugiEngine {
+	class EngineComputePipeline {
+		public:
+			EngineComputePipeline(EngineDevice& device, VkPipelineLayout pipelineLayout, const std::string& compFilePath);
+			~EngineComputePipeline();
+
+			EngineComputePipeline(const EngineComputePipeline&) = delete;
+			EngineComputePipeline& operator =(const EngineComputePipeline&) = delete;
+
+			void bind(VkCommandBuffer commandBuffer);
+			void dispatch(VkCommandBuffer commandBuffer, uint32_t groupCountX, uint32_t groupCountY = 1, uint32_t groupCountZ = 1);
+
+		private:
+			EngineDevice& engineDevice;
+			VkPipeline computePipeline;
+			VkShaderModule shaderModule;
+
+			void createComputePipeline(VkPipelineLayout pipelineLayout, const std::string& compFilePath);
+	};
+}
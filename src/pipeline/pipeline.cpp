@@ -242,7 +242,7 @@ namespace nugiEngine {
 		pipelineInfo.basePipelineIndex = -1;
 		pipelineInfo.basePipelineHandle = VK_NULL_HANDLE;
 
-		if (vkCreateGraphicsPipelines(this->engineDevice.getLogicalDevice(), VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &this->graphicPipeline) != VK_SUCCESS) {
+		if (vkCreateGraphicsPipelines(this->engineDevice.getLogicalDevice(), this->engineDevice.getPipelineCache(), 1, &pipelineInfo, nullptr, &this->graphicPipeline) != VK_SUCCESS) {
 			throw std::runtime_error("failed to create graphic pipelines");
 		}
 		
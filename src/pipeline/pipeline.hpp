@@ -67,13 +67,14 @@ namespace nugiEngine {
 
 			void bind(VkCommandBuffer commandBuffer);
 
+			static std::vector<char> readFile(const std::string& filepath);
+			static void createShaderModule(EngineDevice& appDevice, const std::vector<char>& code, VkShaderModule* shaderModule);
+
 		private:
 			EngineDevice& engineDevice;
 			VkPipeline graphicPipeline;
 			std::vector<VkShaderModule> shaderModules{};
 			
-			static std::vector<char> readFile(const std::string& filepath);
-			static void createShaderModule(EngineDevice& appDevice, const std::vector<char>& code, VkShaderModule* shaderModule);
 			void createGraphicPipeline(const PipelineConfigInfo& configInfo);
 	};
 }
\ No newline at end of file
@@ -6,13 +6,14 @@
 #include <string>
 
 namespace nugiEngine {
-	EngineRenderer::EngineRenderer(EngineWindow& window, EngineDevice& device) : appDevice{device}, appWindow{window} {
+	EngineRenderer::EngineRenderer(EngineWindow& window, EngineDevice& device, uint32_t recordThreadCount) : appDevice{device}, appWindow{window} {
 		this->recreateSwapChain();
 		this->createSyncObjects(this->swapChain->imageCount());
 
-		this->commandBuffers = EngineCommandBuffer::createCommandBuffers(device, EngineSwapChain::MAX_FRAMES_IN_FLIGHT);
+		this->commandPoolManager = std::make_unique<EngineCommandPoolManager>(device, recordThreadCount, EngineSwapChain::MAX_FRAMES_IN_FLIGHT);
 
-		this->createGlobalBuffers(sizeof(GlobalUBO), sizeof(GlobalLight));
+		this->createFrameAllocator();
+		this->createLightClusterBuffer();
 		this->createGlobalUboDescriptor();
 	}
 
@@ -46,59 +47,59 @@ namespace nugiEngine {
 		}
 	}
 
-	void EngineRenderer::createGlobalBuffers(unsigned long sizeUBO, unsigned long sizeLightBuffer) {
-		this->globalUniformBuffers.resize(EngineSwapChain::MAX_FRAMES_IN_FLIGHT);
-		this->globalLightBuffers.resize(EngineSwapChain::MAX_FRAMES_IN_FLIGHT);
-
-		for (int i = 0; i < this->globalUniformBuffers.size(); i++) {
-			this->globalUniformBuffers[i] = std::make_unique<EngineBuffer>(
-				this->appDevice,
-				sizeUBO,
-				1,
-				VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
-				VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT
-			);
-
-			this->globalLightBuffers[i] = std::make_unique<EngineBuffer>(
-				this->appDevice,
-				sizeLightBuffer,
-				1,
-				VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
-				VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT
-			);
-
-			this->globalUniformBuffers[i]->map();
-			this->globalLightBuffers[i]->map();
-		}
+	void EngineRenderer::createFrameAllocator() {
+		this->frameAllocator = std::make_unique<EngineFrameAllocator>(
+			this->appDevice,
+			16 * 1024 * 1024,
+			8 * 1024 * 1024,
+			EngineSwapChain::MAX_FRAMES_IN_FLIGHT,
+			VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT 
+				| VK_BUFFER_USAGE_TRANSFER_SRC_BIT
+		);
+	}
+
+	void EngineRenderer::createLightClusterBuffer() {
+		this->lightClusterBuffer = std::make_unique<EngineBuffer>(
+			this->appDevice,
+			sizeof(LightClusterData),
+			EngineSwapChain::MAX_FRAMES_IN_FLIGHT,
+			VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+			VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+			this->appDevice.getProperties().limits.minStorageBufferOffsetAlignment
+		);
 	}
 
 	void EngineRenderer::createGlobalUboDescriptor() {
 		this->descriptorPool = 
 			EngineDescriptorPool::Builder(this->appDevice)
 				.setMaxSets(100 * EngineSwapChain::MAX_FRAMES_IN_FLIGHT)
-				.addPoolSize(VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, EngineSwapChain::MAX_FRAMES_IN_FLIGHT)
+				.addPoolSize(VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, 1)
+				.addPoolSize(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC, 15)
+				.addPoolSize(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, EngineSwapChain::MAX_FRAMES_IN_FLIGHT)
 				.addPoolSize(VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 100)
 				.build();
 
 		this->globalDescSetLayout = 
 			EngineDescriptorSetLayout::Builder(this->appDevice)
-				.addBinding(0, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, VK_SHADER_STAGE_ALL_GRAPHICS)
-				.addBinding(1, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, VK_SHADER_STAGE_ALL_GRAPHICS)
+				.addBinding(0, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, VK_SHADER_STAGE_ALL_GRAPHICS)
+				.addBinding(1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC, VK_SHADER_STAGE_ALL_GRAPHICS)
+				.addBinding(2, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC, VK_SHADER_STAGE_ALL_GRAPHICS)
 				.build();
 
-		this->globalDescriptorSets.resize(this->globalUniformBuffers.size());
-		
-		for (int i = 0; i < this->globalUniformBuffers.size(); i++) {
-			this->globalDescriptorSets[i] = std::make_shared<VkDescriptorSet>();
+		// one set for every frame: the frame allocator offsets select the data
+		this->globalDescriptorSet = std::make_shared<VkDescriptorSet>();
 
-			auto globalBufferInfo = this->globalUniformBuffers[i]->descriptorInfo();
-			auto lightBufferInfo = this->globalLightBuffers[i]->descriptorInfo();
+		auto globalBufferInfo = this->frameAllocator->descriptorInfo(sizeof(GlobalUBO));
+		// the light count varies, the range covers the most lights the light cluster system uploads
+		auto lightBufferInfo = this->frameAllocator->descriptorInfo(LIGHT_BUFFER_RANGE);
+		// one frame's cluster lists, the dynamic offset picks the frame
+		auto clusterBufferInfo = this->lightClusterBuffer->descriptorInfo(sizeof(LightClusterData));
 
-			EngineDescriptorWriter(*this->globalDescSetLayout, *this->descriptorPool)
-				.writeBuffer(0, &globalBufferInfo)
-				.writeBuffer(1, &lightBufferInfo)
-				.build(this->globalDescriptorSets[i].get());
-		}
+		EngineDescriptorWriter(*this->globalDescSetLayout, *this->descriptorPool)
+			.writeBuffer(0, &globalBufferInfo)
+			.writeBuffer(1, &lightBufferInfo)
+			.writeBuffer(2, &clusterBufferInfo)
+			.build(this->globalDescriptorSet.get());
 	}
 
 	void EngineRenderer::createSyncObjects(int imageCount) {
@@ -124,16 +125,6 @@ namespace nugiEngine {
     }
   }
 
-	void EngineRenderer::writeUniformBuffer(int frameIndex, void* data, VkDeviceSize size, VkDeviceSize offset) {
-		this->globalUniformBuffers[frameIndex]->writeToBuffer(data, size, offset);
-		this->globalUniformBuffers[frameIndex]->flush(size, offset);
-	}
-
-	void EngineRenderer::writeLightBuffer(int frameIndex, void* data, VkDeviceSize size, VkDeviceSize offset) {
-		this->globalLightBuffers[frameIndex]->writeToBuffer(data, size, offset);
-		this->globalLightBuffers[frameIndex]->flush(size, offset);
-	}
-
 	bool EngineRenderer::acquireFrame() {
 		assert(!this->isFrameStarted && "can't acquire frame while frame still in progress");
 
@@ -147,6 +138,10 @@ namespace nugiEngine {
 			throw std::runtime_error("failed to acquire swap chain image");
 		}
 
+		// the fence of this frame has signaled, so everything recorded for it can be reset at once
+		this->frameAllocator->beginFrame(this->currentFrameIndex);
+		this->commandPoolManager->resetFrame(this->currentFrameIndex);
+
 		this->isFrameStarted = true;
 		return true;
 	}
@@ -154,8 +149,10 @@ namespace nugiEngine {
 	std::shared_ptr<EngineCommandBuffer> EngineRenderer::beginCommand() {
 		assert(this->isFrameStarted && "can't start command while frame still in progress");
 
-		this->commandBuffers[this->currentFrameIndex]->beginReccuringCommand();
-		return this->commandBuffers[this->currentFrameIndex];
+		this->currentCommandBuffer = this->commandPoolManager->acquireCommandBuffer(0, this->currentFrameIndex);
+		this->currentCommandBuffer->beginSingleTimeCommand();
+
+		return this->currentCommandBuffer;
 	}
 
 	void EngineRenderer::endCommand(std::shared_ptr<EngineCommandBuffer> commandBuffer) {
@@ -172,6 +169,7 @@ namespace nugiEngine {
 
     imagesInFlight[this->currentImageIndex] = this->inFlightFences[this->currentFrameIndex];
     vkResetFences(this->appDevice.getLogicalDevice(), 1, &this->inFlightFences[this->currentFrameIndex]);
+    this->frameAllocator->flush();
 
     std::vector<VkSemaphore> waitSemaphores = {this->imageAvailableSemaphores[this->currentFrameIndex]};
 		std::vector<VkSemaphore> signalSemaphores = {this->renderFinishedSemaphores[this->currentFrameIndex]};
@@ -189,6 +187,7 @@ namespace nugiEngine {
 
     imagesInFlight[this->currentImageIndex] = this->inFlightFences[this->currentFrameIndex];
     vkResetFences(this->appDevice.getLogicalDevice(), 1, &this->inFlightFences[this->currentFrameIndex]);
+    this->frameAllocator->flush();
 
     std::vector<VkSemaphore> waitSemaphores = {this->imageAvailableSemaphores[this->currentFrameIndex]};
 		std::vector<VkSemaphore> signalSemaphores = {this->renderFinishedSemaphores[this->currentFrameIndex]};
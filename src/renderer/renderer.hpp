@@ -4,8 +4,10 @@
 #include "../device/device.hpp"
 #include "../swap_chain/swap_chain.hpp"
 #include "../buffer/buffer.hpp"
+#include "../buffer/frame_allocator.hpp"
 #include "../descriptor/descriptor.hpp"
 #include "../command/command_buffer.hpp"
+#include "../command/command_pool_manager.hpp"
 
 #include <memory>
 #include <vector>
@@ -15,7 +17,8 @@ namespace nugiEngine {
 	class EngineRenderer
 	{
 		public:
-			EngineRenderer(EngineWindow& window, EngineDevice& device);
+			// thread 0 of the command pool manager is the one calling beginCommand
+			EngineRenderer(EngineWindow& window, EngineDevice& device, uint32_t recordThreadCount = 1);
 			~EngineRenderer();
 
 			EngineRenderer(const EngineRenderer&) = delete;
@@ -26,11 +29,14 @@ namespace nugiEngine {
 			
 			std::shared_ptr<EngineDescriptorPool> getDescriptorPool() const { return this->descriptorPool; }
 			std::shared_ptr<EngineDescriptorSetLayout> getglobalDescSetLayout() const { return this->globalDescSetLayout; }
-			std::shared_ptr<VkDescriptorSet> getGlobalDescriptorSets(int index) const { return this->globalDescriptorSets[index]; }
+			std::shared_ptr<VkDescriptorSet> getGlobalDescriptorSet() const { return this->globalDescriptorSet; }
+			EngineFrameAllocator* getFrameAllocator() const { return this->frameAllocator.get(); }
+			EngineBuffer* getLightClusterBuffer() const { return this->lightClusterBuffer.get(); }
+			EngineCommandPoolManager* getCommandPoolManager() const { return this->commandPoolManager.get(); }
 
 			VkCommandBuffer getCommandBuffer() const { 
 				assert(this->isFrameStarted && "cannot get command buffer when frame is not in progress");
-				return this->commandBuffers[this->currentFrameIndex]->getCommandBuffer();
+				return this->currentCommandBuffer->getCommandBuffer();
 			}
 
 			int getFrameIndex() {
@@ -43,9 +49,6 @@ namespace nugiEngine {
 				return this->currentImageIndex;
 			}
 
-			void writeUniformBuffer(int frameIndex, void* data, VkDeviceSize size = VK_WHOLE_SIZE, VkDeviceSize offset = 0);
-			void writeLightBuffer(int frameIndex, void* data, VkDeviceSize size = VK_WHOLE_SIZE, VkDeviceSize offset = 0);
-
 			std::shared_ptr<EngineCommandBuffer> beginCommand();
 			void endCommand(std::shared_ptr<EngineCommandBuffer>);
 
@@ -57,7 +60,8 @@ namespace nugiEngine {
 
 		private:
 			void recreateSwapChain();
-			void createGlobalBuffers(unsigned long sizeUBO, unsigned long sizeLightBuffer);
+			void createFrameAllocator();
+			void createLightClusterBuffer();
 			void createGlobalUboDescriptor();
 			void createSyncObjects(int imageCount);
 
@@ -65,14 +69,18 @@ namespace nugiEngine {
 			EngineDevice& appDevice;
 
 			std::shared_ptr<EngineSwapChain> swapChain;
-			std::vector<std::shared_ptr<EngineCommandBuffer>> commandBuffers;
+			std::unique_ptr<EngineCommandPoolManager> commandPoolManager;
+			std::shared_ptr<EngineCommandBuffer> currentCommandBuffer;
 
 			std::shared_ptr<EngineDescriptorPool> descriptorPool{};
 			std::shared_ptr<EngineDescriptorSetLayout> globalDescSetLayout{};
-			std::vector<std::shared_ptr<VkDescriptorSet>> globalDescriptorSets;
+			std::shared_ptr<VkDescriptorSet> globalDescriptorSet;
+
+			// transient per-frame data (global ubo, lights, ...) bound through dynamic offsets
+			std::unique_ptr<EngineFrameAllocator> frameAllocator;
 
-			std::vector<std::shared_ptr<EngineBuffer>> globalLightBuffers;
-			std::vector<std::shared_ptr<EngineBuffer>> globalUniformBuffers;
+			// one LightClusterData per frame in flight, written & read on the GPU only
+			std::unique_ptr<EngineBuffer> lightClusterBuffer;
 
 			std::vector<VkSemaphore> imageAvailableSemaphores;
 			std::vector<VkSemaphore> renderFinishedSemaphores;
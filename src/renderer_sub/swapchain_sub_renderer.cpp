@@ -5,13 +5,46 @@
 
 namespace nugiEngine {
   EngineSwapChainSubRenderer::EngineSwapChainSubRenderer(EngineDevice &device, std::vector<std::shared_ptr<EngineImage>> swapChainImages, VkFormat swapChainImageFormat, int imageCount, int width, int height) 
-    : device{device}, swapChainImages{swapChainImages}, width{width}, height{height}
+    : device{device}, swapChainImages{swapChainImages}, swapChainImageFormat{swapChainImageFormat}, width{width}, height{height}
   {
     this->createColorResources(swapChainImageFormat, imageCount);
     this->createDepthResources(imageCount);
     this->createRenderPass(swapChainImageFormat, imageCount);
   }
 
+  bool EngineSwapChainSubRenderer::resize(std::vector<std::shared_ptr<EngineImage>> swapChainImages, VkFormat swapChainImageFormat, int imageCount, int width, int height) {
+    this->swapChainImages = swapChainImages;
+    this->width = width;
+    this->height = height;
+
+    this->createColorResources(swapChainImageFormat, imageCount);
+    this->createDepthResources(imageCount);
+
+    if (swapChainImageFormat != this->swapChainImageFormat) {
+      this->swapChainImageFormat = swapChainImageFormat;
+      this->createRenderPass(swapChainImageFormat, imageCount);
+
+      return false;
+    }
+
+    this->renderPass->recreateFramebuffers(this->getFramebufferViews(imageCount), width, height);
+    return true;
+  }
+
+  std::vector<std::vector<VkImageView>> EngineSwapChainSubRenderer::getFramebufferViews(int imageCount) {
+    std::vector<std::vector<VkImageView>> viewImages{};
+
+    for (int i = 0; i < imageCount; i++) {
+      viewImages.push_back({
+        this->colorImages[i]->getImageView(), 
+        this->depthImages[i]->getImageView(),
+        this->swapChainImages[i]->getImageView()
+      });
+    }
+
+    return viewImages;
+  }
+
   void EngineSwapChainSubRenderer::createColorResources(VkFormat swapChainImageFormat, int imageCount) {
     VkFormat colorFormat = swapChainImageFormat;
 
@@ -116,12 +149,8 @@ namespace nugiEngine {
 			.addSubpass(subpass)
 			.addDependency(dependency);
 
-    for (int i = 0; i < imageCount; i++) {
-			renderPassBuilder.addViewImages({
-        this->colorImages[i]->getImageView(), 
-        this->depthImages[i]->getImageView(),
-        this->swapChainImages[i]->getImageView()
-      });
+    for (auto& viewImages : this->getFramebufferViews(imageCount)) {
+			renderPassBuilder.addViewImages(viewImages);
     }
 
 		this->renderPass = renderPassBuilder.build();
@@ -134,7 +163,7 @@ namespace nugiEngine {
       VK_FORMAT_FEATURE_DEPTH_STENCIL_ATTACHMENT_BIT);
   }
 
-  void EngineSwapChainSubRenderer::beginRenderPass(std::shared_ptr<EngineCommandBuffer> commandBuffer, int currentImageIndex) {
+  void EngineSwapChainSubRenderer::beginRenderPass(std::shared_ptr<EngineCommandBuffer> commandBuffer, int currentImageIndex, VkSubpassContents contents) {
 		VkRenderPassBeginInfo renderBeginInfo{};
 		renderBeginInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
 		renderBeginInfo.renderPass = this->getRenderPass()->getRenderPass();
@@ -149,8 +178,15 @@ namespace nugiEngine {
 		renderBeginInfo.clearValueCount = static_cast<uint32_t>(clearValues.size());
 		renderBeginInfo.pClearValues = clearValues.data();
 
-		vkCmdBeginRenderPass(commandBuffer->getCommandBuffer(), &renderBeginInfo, VK_SUBPASS_CONTENTS_INLINE);
+		vkCmdBeginRenderPass(commandBuffer->getCommandBuffer(), &renderBeginInfo, contents);
+
+		// secondary command buffers do not inherit dynamic state, they set it themselves
+		if (contents == VK_SUBPASS_CONTENTS_INLINE) {
+			this->setViewportAndScissor(commandBuffer);
+		}
+	}
 
+	void EngineSwapChainSubRenderer::setViewportAndScissor(std::shared_ptr<EngineCommandBuffer> commandBuffer) {
 		VkViewport viewport{};
 		viewport.x = 0.0f;
 		viewport.y = 0.0f;
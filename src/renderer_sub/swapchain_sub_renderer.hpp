@@ -13,10 +13,16 @@ namespace nugiEngine {
       EngineSwapChainSubRenderer(EngineDevice &device, std::vector<std::shared_ptr<EngineImage>> swapChainImages, VkFormat swapChainImageFormat, int imageCount, int width, int height);
       std::shared_ptr<EngineRenderPass> getRenderPass() const { return this->renderPass; }
 
-      void beginRenderPass(std::shared_ptr<EngineCommandBuffer> commandBuffer, int currentImageIndex);
+      // rebuilds only the size dependent attachments & framebuffers; returns false if the
+      // render pass had to be replaced too, in which case its pipelines must be rebuilt
+      bool resize(std::vector<std::shared_ptr<EngineImage>> swapChainImages, VkFormat swapChainImageFormat, int imageCount, int width, int height);
+
+      void beginRenderPass(std::shared_ptr<EngineCommandBuffer> commandBuffer, int currentImageIndex, VkSubpassContents contents = VK_SUBPASS_CONTENTS_INLINE);
+      void setViewportAndScissor(std::shared_ptr<EngineCommandBuffer> commandBuffer);
 			void endRenderPass(std::shared_ptr<EngineCommandBuffer> commandBuffer);
     private:
       int width, height;
+      VkFormat swapChainImageFormat;
       EngineDevice &device;
 
       std::vector<std::shared_ptr<EngineImage>> colorImages;
@@ -30,6 +36,7 @@ namespace nugiEngine {
       void createColorResources(VkFormat swapChainImageFormat, int imageCount);
       void createDepthResources(int imageCount);
       void createRenderPass(VkFormat swapChainImageFormat, int imageCount);
+      std::vector<std::vector<VkImageView>> getFramebufferViews(int imageCount);
   };
   
 } // namespace nugiEngine
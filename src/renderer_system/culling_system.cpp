@@ -0,0 +1,549 @@
+#include "culling_system.hpp"
+#include "../swap_chain/swap_chain.hpp"
+
+#define GLM_FORCE_RADIANS
+#define GLM_FORCE_DEPTH_ZERO_TO_ONE
+#include <glm/glm.hpp>
+
+#include <stdexcept>
+#include <algorithm>
+#include <functional>
+#include <cstring>
+
+namespace nugiEngine {
+
+	constexpr uint32_t NO_DRAW_OBJECT = 0xFFFFFFFF;
+
+	struct CullPushConstant {
+		glm::mat4 viewProjection{1.0f};
+		uint32_t objectCount = 0;
+		uint32_t groupCount = 0;
+	};
+
+	EngineCullingSystem::EngineCullingSystem(EngineDevice& device, EngineDescriptorPool &descriptorPool, EngineFrameAllocator &frameAllocator)
+		: appDevice{device}, descriptorPool{descriptorPool}, frameAllocator{frameAllocator}
+	{
+		// without multi draw, the indirect count would be capped at one draw anyway
+		this->useDrawIndirectCount = device.isDrawIndirectCountSupported() && device.isMultiDrawIndirectSupported();
+
+		this->retiredObjectBuffers.resize(EngineSwapChain::MAX_FRAMES_IN_FLIGHT);
+
+		this->createObjectBuffer(64);
+		this->createDescriptor();
+		this->createPipelineLayout();
+		this->createPipelines();
+	}
+
+	EngineCullingSystem::~EngineCullingSystem() {
+		vkDestroyPipelineLayout(this->appDevice.getLogicalDevice(), this->pipelineLayout, nullptr);
+	}
+
+	void EngineCullingSystem::createDescriptor() {
+		this->cullDescSetLayout =
+			EngineDescriptorSetLayout::Builder(this->appDevice)
+				.addBinding(0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT)
+				.addBinding(1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC, VK_SHADER_STAGE_COMPUTE_BIT)
+				.addBinding(2, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC, VK_SHADER_STAGE_COMPUTE_BIT)
+				.addBinding(3, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC, VK_SHADER_STAGE_COMPUTE_BIT)
+				.addBinding(4, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC, VK_SHADER_STAGE_COMPUTE_BIT)
+				.addBinding(5, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC, VK_SHADER_STAGE_COMPUTE_BIT)
+				.build();
+
+		// the object buffer is bound whole; the other bindings share one fixed range of the frame allocator
+		// and the dynamic offsets pick where this frame's arrays start
+		auto objectBufferInfo = this->objectBuffer->descriptorInfo();
+		auto bufferInfo = this->frameAllocator.descriptorInfo(this->frameAllocator.getMaxBindingRange());
+
+		this->cullDescSets.resize(EngineSwapChain::MAX_FRAMES_IN_FLIGHT);
+		this->cullDescSetObjectBuffers.assign(EngineSwapChain::MAX_FRAMES_IN_FLIGHT, this->objectBuffer->getBuffer());
+
+		for (auto &descSet : this->cullDescSets) {
+			EngineDescriptorWriter(*this->cullDescSetLayout, this->descriptorPool)
+				.writeBuffer(0, &objectBufferInfo)
+				.writeBuffer(1, &bufferInfo)
+				.writeBuffer(2, &bufferInfo)
+				.writeBuffer(3, &bufferInfo)
+				.writeBuffer(4, &bufferInfo)
+				.writeBuffer(5, &bufferInfo)
+				.build(&descSet);
+		}
+	}
+
+	void EngineCullingSystem::createObjectBuffer(uint32_t capacity) {
+		this->objectBuffer = std::make_unique<EngineBuffer>(
+			this->appDevice,
+			sizeof(CullObjectData),
+			capacity,
+			VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+			VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT
+		);
+
+		this->isObjectBufferStale = true;
+	}
+
+	void EngineCullingSystem::createPipelineLayout() {
+		VkPushConstantRange pushConstantRange{};
+		pushConstantRange.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+		pushConstantRange.offset = 0;
+		pushConstantRange.size = sizeof(CullPushConstant);
+
+		std::vector<VkDescriptorSetLayout> descriptorSetLayouts = { this->cullDescSetLayout->getDescriptorSetLayout() };
+
+		VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
+		pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+		pipelineLayoutInfo.setLayoutCount = static_cast<uint32_t>(descriptorSetLayouts.size());
+		pipelineLayoutInfo.pSetLayouts = descriptorSetLayouts.data();
+		pipelineLayoutInfo.pushConstantRangeCount = 1;
+		pipelineLayoutInfo.pPushConstantRanges = &pushConstantRange;
+
+		if (vkCreatePipelineLayout(this->appDevice.getLogicalDevice(), &pipelineLayoutInfo, nullptr, &this->pipelineLayout) != VK_SUCCESS) {
+			throw std::runtime_error("failed to create pipeline layout!");
+		}
+	}
+
+	void EngineCullingSystem::createPipelines() {
+		assert(this->pipelineLayout != nullptr && "Cannot create pipeline before pipeline layout");
+
+		this->cullPipeline = std::make_unique<EngineComputePipeline>(this->appDevice, this->pipelineLayout, "shader/frustum_cull.comp.spv");
+		this->compactPipeline = std::make_unique<EngineComputePipeline>(this->appDevice, this->pipelineLayout, "shader/draw_compact.comp.spv");
+	}
+
+	void EngineCullingSystem::setScene(EngineScene &scene) {
+		this->scene = &scene;
+
+		this->collectObjects();
+		this->updatePendingObjects();
+		this->rebuildDrawGroups();
+	}
+
+	// only entities with a model & a transform are renderables; nothing else is ever visited
+	void EngineCullingSystem::collectObjects() {
+		auto& models = this->scene->getModels();
+		auto& textures = this->scene->getTextures();
+		auto& transforms = this->scene->getTransforms();
+
+		this->pendingObjects.clear();
+		this->drawObjects.clear();
+
+		for (uint32_t i = 0; i < models.size(); i++) {
+			EngineEntity entity = models.getEntities()[i];
+			auto& model = models[i].model;
+
+			// indirect draws are always indexed
+			if (model == nullptr || model->getMesh().indexCount == 0 || !transforms.contains(entity)) continue;
+
+			DrawObject object{};
+			object.entity = entity;
+			object.transformIndex = transforms.indexOf(entity);
+			object.model = model;
+
+			if (auto texture = textures.get(entity)) {
+				object.texture = texture->texture;
+				object.textureDescSet = texture->textureDescSet;
+			}
+
+			this->pendingObjects.push_back(std::move(object));
+		}
+
+		this->modelsVersion = models.getVersion();
+		this->texturesVersion = textures.getVersion();
+		this->transformsVersion = transforms.getVersion();
+	}
+
+	bool EngineCullingSystem::updatePendingObjects() {
+		auto readyBegin = std::stable_partition(this->pendingObjects.begin(), this->pendingObjects.end(), [](const DrawObject &obj) {
+			return !obj.model->isReady() || (obj.texture != nullptr && !obj.texture->isReady());
+		});
+
+		if (readyBegin == this->pendingObjects.end()) return false;
+
+		this->drawObjects.insert(this->drawObjects.end(), std::make_move_iterator(readyBegin), std::make_move_iterator(this->pendingObjects.end()));
+		this->pendingObjects.erase(readyBegin, this->pendingObjects.end());
+
+		return true;
+	}
+
+	void EngineCullingSystem::rebuildDrawGroups() {
+		std::sort(this->drawObjects.begin(), this->drawObjects.end(), [](const DrawObject &a, const DrawObject &b) {
+			if (a.model->getGeometryPool() != b.model->getGeometryPool()) {
+				return std::less<EngineGeometryPool*>{}(a.model->getGeometryPool(), b.model->getGeometryPool());
+			}
+
+			VkDescriptorSet aTexture = a.textureDescSet != nullptr ? *a.textureDescSet : VK_NULL_HANDLE;
+			VkDescriptorSet bTexture = b.textureDescSet != nullptr ? *b.textureDescSet : VK_NULL_HANDLE;
+
+			if (aTexture != bTexture) {
+				return std::less<VkDescriptorSet>{}(aTexture, bTexture);
+			}
+
+			return std::less<EngineModel*>{}(a.model.get(), b.model.get());
+		});
+
+		this->objectGroups.resize(this->drawObjects.size());
+		this->drawGroups.clear();
+		this->buckets.clear();
+
+		// the objects moved around, so every entry of the object buffer is rewritten
+		this->transformObjects.assign(this->scene->getTransforms().size(), NO_DRAW_OBJECT);
+		this->isObjectBufferStale = true;
+
+		EngineModel* groupModel = nullptr;
+
+		for (uint32_t i = 0; i < this->drawObjects.size(); i++) {
+			auto& obj = this->drawObjects[i];
+
+			VkDescriptorSet texture = obj.textureDescSet != nullptr ? *obj.textureDescSet : VK_NULL_HANDLE;
+			VkDescriptorSet bucketTexture = VK_NULL_HANDLE;
+
+			if (!this->buckets.empty() && this->buckets.back().textureDescSet != nullptr) {
+				bucketTexture = *this->buckets.back().textureDescSet;
+			}
+
+			if (this->buckets.empty() || this->buckets.back().geometryPool != obj.model->getGeometryPool() || bucketTexture != texture) {
+				EngineDrawBucket bucket{};
+				bucket.index = static_cast<uint32_t>(this->buckets.size());
+				bucket.geometryPool = obj.model->getGeometryPool();
+				bucket.textureDescSet = obj.textureDescSet;
+				bucket.firstGroup = static_cast<uint32_t>(this->drawGroups.size());
+
+				this->buckets.push_back(bucket);
+				groupModel = nullptr;
+			}
+
+			if (obj.model.get() != groupModel) {
+				const auto& mesh = obj.model->getMesh();
+
+				CullDrawGroup group{};
+				group.command.indexCount = mesh.indexCount;
+				group.command.instanceCount = 0;
+				group.command.firstIndex = mesh.firstIndex;
+				group.command.vertexOffset = static_cast<int32_t>(mesh.firstVertex);
+				group.command.firstInstance = i; // room for every object of the group, even if all are visible
+				group.outputBase = this->buckets.back().firstGroup;
+				group.bucket = this->buckets.back().index;
+
+				this->drawGroups.push_back(group);
+				this->buckets.back().groupCount++;
+
+				groupModel = obj.model.get();
+			}
+
+			this->objectGroups[i] = static_cast<uint32_t>(this->drawGroups.size() - 1);
+			this->transformObjects[obj.transformIndex] = i;
+		}
+	}
+
+	void EngineCullingSystem::prepare(FrameInfo &frameInfo, EngineThreadPool &threadPool) {
+		if (this->scene == nullptr) return;
+
+		// the fence of this frame index has signaled, nothing still reads the buffers retired with it
+		this->frameIndex = static_cast<uint32_t>(frameInfo.frameIndex);
+		this->retiredObjectBuffers[this->frameIndex].clear();
+
+		auto& transforms = this->scene->getTransforms();
+
+		bool isStructureChanged = this->modelsVersion != this->scene->getModels().getVersion() 
+			|| this->texturesVersion != this->scene->getTextures().getVersion() || this->transformsVersion != transforms.getVersion();
+
+		if (isStructureChanged) {
+			this->collectObjects();
+		}
+
+		if (this->updatePendingObjects() || isStructureChanged) {
+			this->rebuildDrawGroups();
+		}
+
+		this->stats = EngineCullingStats{};
+		this->objectCopies.clear();
+
+		if (this->drawObjects.empty()) return;
+
+		uint32_t candidateCount = static_cast<uint32_t>(this->drawObjects.size());
+		uint32_t groupCount = static_cast<uint32_t>(this->drawGroups.size());
+		uint32_t bucketCount = static_cast<uint32_t>(this->buckets.size());
+
+		this->updateObjectData(threadPool);
+
+		this->sphereVisible.resize(candidateCount);
+		this->boxVisible.resize(candidateCount);
+
+		EngineFrustum frustum{frameInfo.camera};
+
+		// every batch only touches its own range of the scratch arrays
+		threadPool.parallelFor(candidateCount, 256, [this, &frustum, &transforms](uint32_t begin, uint32_t end, uint32_t threadIndex) {
+			// coarse sphere test over the batch, then the tighter box test on what survived
+			frustum.testSpheres(this->sphereX.data() + begin, this->sphereY.data() + begin, this->sphereZ.data() + begin, 
+				this->sphereRadius.data() + begin, this->sphereVisible.data() + begin, end - begin);
+
+			for (uint32_t i = begin; i < end; i++) {
+				this->boxVisible[i] = 0;
+				if (!this->sphereVisible[i]) continue;
+
+				const auto& modelMatrix = transforms.getModelMatrix(this->drawObjects[i].transformIndex);
+				const auto& box = this->drawObjects[i].model->getBoundingBox();
+
+				glm::vec3 boxCenter = glm::vec3(modelMatrix * glm::vec4(box.center(), 1.0f));
+				glm::vec3 boxExtents = box.extents();
+				boxExtents = glm::abs(glm::vec3(modelMatrix[0])) * boxExtents.x + glm::abs(glm::vec3(modelMatrix[1])) * boxExtents.y 
+					+ glm::abs(glm::vec3(modelMatrix[2])) * boxExtents.z;
+
+				this->boxVisible[i] = frustum.testBox(boxCenter, boxExtents) ? 1 : 0;
+			}
+		});
+
+		// the shaders see every array through the same fixed binding range, the instances are the largest
+		if (sizeof(InstanceData) * candidateCount > this->frameAllocator.getMaxBindingRange()
+			|| sizeof(CullDrawGroup) * groupCount > this->frameAllocator.getMaxBindingRange()) {
+			throw std::runtime_error("too many objects to cull in one frame!");
+		}
+
+		auto visibleAllocation = this->frameAllocator.allocate(sizeof(uint32_t) * candidateCount);
+		auto groupAllocation = this->frameAllocator.allocate(sizeof(CullDrawGroup) * groupCount);
+		auto instanceAllocation = this->frameAllocator.allocate(sizeof(InstanceData) * candidateCount);
+		auto countAllocation = this->frameAllocator.allocate(sizeof(uint32_t) * bucketCount);
+		auto commandAllocation = this->frameAllocator.allocate(sizeof(VkDrawIndexedIndirectCommand) * groupCount);
+
+		this->visibleOffset = visibleAllocation.offset;
+		this->groupOffset = groupAllocation.offset;
+		this->instanceOffset = instanceAllocation.offset;
+		this->countOffset = countAllocation.offset;
+		this->commandOffset = commandAllocation.offset;
+
+		// only the indices of the survivors go to the GPU, their data already sits in the object buffer;
+		// compacting stays serial so the objects keep their draw group order
+		auto visibleObjects = static_cast<uint32_t*>(visibleAllocation.mapped);
+		uint32_t objectCount = 0;
+
+		for (uint32_t i = 0; i < candidateCount; i++) {
+			if (!this->sphereVisible[i]) {
+				this->stats.sphereRejectedCount++;
+				continue;
+			}
+
+			if (!this->boxVisible[i]) {
+				this->stats.boxRejectedCount++;
+				continue;
+			}
+
+			visibleObjects[objectCount++] = i;
+		}
+
+		this->stats.testedCount = candidateCount;
+		this->stats.submittedCount = objectCount;
+
+		std::memcpy(groupAllocation.mapped, this->drawGroups.data(), sizeof(CullDrawGroup) * groupCount);
+		std::memset(countAllocation.mapped, 0, sizeof(uint32_t) * bucketCount);
+
+		// point this frame's set at the current object buffer; its last use has finished
+		if (this->cullDescSetObjectBuffers[this->frameIndex] != this->objectBuffer->getBuffer()) {
+			auto objectBufferInfo = this->objectBuffer->descriptorInfo();
+
+			EngineDescriptorWriter(*this->cullDescSetLayout, this->descriptorPool)
+				.writeBuffer(0, &objectBufferInfo)
+				.overwrite(&this->cullDescSets[this->frameIndex]);
+
+			this->cullDescSetObjectBuffers[this->frameIndex] = this->objectBuffer->getBuffer();
+		}
+	}
+
+	// stages the object data & world spheres of the draw objects whose transform changed since the last
+	// frame, or of all of them after a rebuild; a static scene stages nothing
+	void EngineCullingSystem::updateObjectData(EngineThreadPool &threadPool) {
+		auto& transforms = this->scene->getTransforms();
+		uint32_t candidateCount = static_cast<uint32_t>(this->drawObjects.size());
+
+		if (this->objectBuffer->getInstanceCount() < candidateCount) {
+			uint32_t capacity = this->objectBuffer->getInstanceCount();
+			while (capacity < candidateCount) capacity *= 2;
+
+			// earlier frames may still read the old buffer, it lives until this frame index comes around again
+			this->retiredObjectBuffers[this->frameIndex].push_back(std::move(this->objectBuffer));
+			this->createObjectBuffer(capacity);
+		}
+
+		this->changedObjects.clear();
+
+		if (this->isObjectBufferStale) {
+			this->sphereX.resize(candidateCount);
+			this->sphereY.resize(candidateCount);
+			this->sphereZ.resize(candidateCount);
+			this->sphereRadius.resize(candidateCount);
+
+			for (uint32_t i = 0; i < candidateCount; i++) {
+				this->changedObjects.push_back(i);
+			}
+		} else {
+			for (uint32_t transformIndex : transforms.getChangedIndices()) {
+				if (transformIndex < this->transformObjects.size() && this->transformObjects[transformIndex] != NO_DRAW_OBJECT) {
+					this->changedObjects.push_back(this->transformObjects[transformIndex]);
+				}
+			}
+
+			// sorted, so neighbouring objects merge into one copy
+			std::sort(this->changedObjects.begin(), this->changedObjects.end());
+		}
+
+		this->isObjectBufferStale = false;
+		if (this->changedObjects.empty()) return;
+
+		uint32_t changedCount = static_cast<uint32_t>(this->changedObjects.size());
+		auto stagingAllocation = this->frameAllocator.allocate(sizeof(CullObjectData) * changedCount);
+		auto objects = static_cast<CullObjectData*>(stagingAllocation.mapped);
+
+		threadPool.parallelFor(changedCount, 256, [this, &transforms, objects](uint32_t begin, uint32_t end, uint32_t threadIndex) {
+			for (uint32_t i = begin; i < end; i++) {
+				uint32_t objectIndex = this->changedObjects[i];
+				auto& obj = this->drawObjects[objectIndex];
+
+				const auto& modelMatrix = transforms.getModelMatrix(obj.transformIndex);
+				glm::vec4 sphere = obj.model->getBoundingSphere();
+
+				objects[i].modelMatrix = modelMatrix;
+				objects[i].normalMatrix = transforms.getNormalMatrix(obj.transformIndex);
+				objects[i].boundingSphere = sphere;
+				objects[i].drawGroup = this->objectGroups[objectIndex];
+
+				glm::vec3 center = glm::vec3(modelMatrix * glm::vec4(glm::vec3(sphere), 1.0f));
+				float maxScale = glm::max(glm::max(glm::length(glm::vec3(modelMatrix[0])), glm::length(glm::vec3(modelMatrix[1]))), glm::length(glm::vec3(modelMatrix[2])));
+
+				this->sphereX[objectIndex] = center.x;
+				this->sphereY[objectIndex] = center.y;
+				this->sphereZ[objectIndex] = center.z;
+				this->sphereRadius[objectIndex] = sphere.w * maxScale;
+			}
+		});
+
+		for (uint32_t i = 0; i < changedCount; i++) {
+			VkDeviceSize srcOffset = stagingAllocation.offset + i * sizeof(CullObjectData);
+			VkDeviceSize dstOffset = this->changedObjects[i] * sizeof(CullObjectData);
+
+			if (!this->objectCopies.empty() && this->objectCopies.back().dstOffset + this->objectCopies.back().size == dstOffset) {
+				this->objectCopies.back().size += sizeof(CullObjectData);
+				continue;
+			}
+
+			this->objectCopies.push_back(VkBufferCopy{ srcOffset, dstOffset, sizeof(CullObjectData) });
+		}
+	}
+
+	void EngineCullingSystem::cull(std::shared_ptr<EngineCommandBuffer> commandBuffer, const GlobalUBO &ubo) {
+		if (this->drawObjects.empty()) return;
+
+		uint32_t objectCount = this->stats.submittedCount;
+		uint32_t groupCount = static_cast<uint32_t>(this->drawGroups.size());
+
+		VkMemoryBarrier barrier{};
+		barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+
+		if (!this->objectCopies.empty()) {
+			// the cull pass of the previous frame may still be reading the entries about to be overwritten
+			vkCmdPipelineBarrier(commandBuffer->getCommandBuffer(), VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
+				0, 0, nullptr, 0, nullptr, 0, nullptr);
+
+			vkCmdCopyBuffer(commandBuffer->getCommandBuffer(), this->frameAllocator.getBuffer(), this->objectBuffer->getBuffer(), 
+				static_cast<uint32_t>(this->objectCopies.size()), this->objectCopies.data());
+
+			barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+			barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+
+			vkCmdPipelineBarrier(commandBuffer->getCommandBuffer(), VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+				0, 1, &barrier, 0, nullptr, 0, nullptr);
+		}
+
+		// ordered by binding number, the object buffer is not dynamic
+		uint32_t dynamicOffsets[] = {
+			static_cast<uint32_t>(this->groupOffset),
+			static_cast<uint32_t>(this->instanceOffset),
+			static_cast<uint32_t>(this->countOffset),
+			static_cast<uint32_t>(this->commandOffset),
+			static_cast<uint32_t>(this->visibleOffset)
+		};
+
+		vkCmdBindDescriptorSets(
+			commandBuffer->getCommandBuffer(),
+			VK_PIPELINE_BIND_POINT_COMPUTE,
+			this->pipelineLayout,
+			0,
+			1,
+			&this->cullDescSets[this->frameIndex],
+			5,
+			dynamicOffsets
+		);
+
+		CullPushConstant pushConstant{};
+		pushConstant.viewProjection = ubo.projection * ubo.view;
+		pushConstant.objectCount = objectCount;
+		pushConstant.groupCount = groupCount;
+
+		vkCmdPushConstants(
+			commandBuffer->getCommandBuffer(),
+			this->pipelineLayout,
+			VK_SHADER_STAGE_COMPUTE_BIT,
+			0,
+			sizeof(CullPushConstant),
+			&pushConstant
+		);
+
+		this->cullPipeline->bind(commandBuffer->getCommandBuffer());
+		this->cullPipeline->dispatch(commandBuffer->getCommandBuffer(), (objectCount + 63) / 64);
+
+		if (this->useDrawIndirectCount) {
+			barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+			barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+
+			vkCmdPipelineBarrier(commandBuffer->getCommandBuffer(), VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+				0, 1, &barrier, 0, nullptr, 0, nullptr);
+
+			// drop the groups nothing survived in, so the draw count only covers real draws
+			this->compactPipeline->bind(commandBuffer->getCommandBuffer());
+			this->compactPipeline->dispatch(commandBuffer->getCommandBuffer(), (groupCount + 63) / 64);
+		}
+
+		barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+		barrier.dstAccessMask = VK_ACCESS_INDIRECT_COMMAND_READ_BIT | VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT;
+
+		vkCmdPipelineBarrier(commandBuffer->getCommandBuffer(), VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+			VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_VERTEX_INPUT_BIT, 0, 1, &barrier, 0, nullptr, 0, nullptr);
+	}
+
+	void EngineCullingSystem::bindInstances(std::shared_ptr<EngineCommandBuffer> commandBuffer) {
+		VkBuffer instanceBuffers[] = { this->frameAllocator.getBuffer() };
+		VkDeviceSize instanceOffsets[] = { this->instanceOffset };
+		vkCmdBindVertexBuffers(commandBuffer->getCommandBuffer(), 1, 1, instanceBuffers, instanceOffsets);
+	}
+
+	void EngineCullingSystem::drawBucket(std::shared_ptr<EngineCommandBuffer> commandBuffer, const EngineDrawBucket &bucket) {
+		VkBuffer buffer = this->frameAllocator.getBuffer();
+
+		if (this->useDrawIndirectCount) {
+			vkCmdDrawIndexedIndirectCount(
+				commandBuffer->getCommandBuffer(),
+				buffer,
+				this->commandOffset + bucket.firstGroup * sizeof(VkDrawIndexedIndirectCommand),
+				buffer,
+				this->countOffset + bucket.index * sizeof(uint32_t),
+				bucket.groupCount,
+				sizeof(VkDrawIndexedIndirectCommand)
+			);
+		} else if (this->appDevice.isMultiDrawIndirectSupported()) {
+			// culled groups stay in as zero instance draws
+			vkCmdDrawIndexedIndirect(
+				commandBuffer->getCommandBuffer(),
+				buffer,
+				this->groupOffset + bucket.firstGroup * sizeof(CullDrawGroup),
+				bucket.groupCount,
+				sizeof(CullDrawGroup)
+			);
+		} else {
+			for (uint32_t i = 0; i < bucket.groupCount; i++) {
+				vkCmdDrawIndexedIndirect(
+					commandBuffer->getCommandBuffer(),
+					buffer,
+					this->groupOffset + (bucket.firstGroup + i) * sizeof(CullDrawGroup),
+					1,
+					sizeof(CullDrawGroup)
+				);
+			}
+		}
+	}
+}
@@ -0,0 +1,148 @@
+#pragma once
+
+#include "../command/command_buffer.hpp"
+#include "../device/device.hpp"
+#include "../camera/frustum.hpp"
+#include "../pipeline/compute_pipeline.hpp"
+#include "../scene/scene.hpp"
+#include "../model/geometry_pool.hpp"
+#include "../frame_info.hpp"
+#include "../buffer/buffer.hpp"
+#include "../buffer/frame_allocator.hpp"
+#include "../descriptor/descriptor.hpp"
+#include "../globalUbo.hpp"
+#include "../thread/thread_pool.hpp"
+
+#include <memory>
+#include <vector>
+
+namespace nugiEngine {
+	// one indirect draw per model & texture; the cull shader fills in instanceCount every frame
+	struct CullDrawGroup {
+		VkDrawIndexedIndirectCommand command{};
+		uint32_t outputBase = 0; // first command slot of the bucket this group belongs to
+		uint32_t bucket = 0;
+		uint32_t padding = 0;
+	};
+
+	// std430 layout, mirrors CullObject in frustum_cull.comp
+	struct CullObjectData {
+		glm::mat4 modelMatrix{1.0f};
+		glm::mat4 normalMatrix{1.0f};
+		glm::vec4 boundingSphere{0.0f};
+		uint32_t drawGroup = 0;
+		uint32_t padding[3];
+	};
+
+	// what the CPU frustum test did during the last cull pass
+	struct EngineCullingStats {
+		uint32_t testedCount = 0;
+		uint32_t sphereRejectedCount = 0;
+		uint32_t boxRejectedCount = 0;
+		uint32_t submittedCount = 0; // handed to the GPU cull pass
+	};
+
+	// draw groups that share a geometry pool & texture, consumed by a single indirect draw
+	struct EngineDrawBucket {
+		uint32_t index = 0;
+		EngineGeometryPool* geometryPool = nullptr;
+		std::shared_ptr<VkDescriptorSet> textureDescSet{};
+		uint32_t firstGroup = 0;
+		uint32_t groupCount = 0;
+	};
+
+	class EngineCullingSystem {
+		public:
+			EngineCullingSystem(EngineDevice& device, EngineDescriptorPool &descriptorPool, EngineFrameAllocator &frameAllocator);
+			~EngineCullingSystem();
+
+			EngineCullingSystem(const EngineCullingSystem&) = delete;
+			EngineCullingSystem& operator = (const EngineCullingSystem&) = delete;
+
+			// the draw groups are only rebuilt here, when a pending upload lands or when model, texture
+			// or transform components are added or removed, not every frame
+			void setScene(EngineScene &scene);
+
+			// the CPU frustum test, spread over the thread pool; fills this frame's cull input and stages the
+			// objects whose transform changed. The scene's transform matrices must be up to date
+			void prepare(FrameInfo &frameInfo, EngineThreadPool &threadPool);
+
+			// records the object copies & culling dispatches for the last prepare, must be called outside of a render pass
+			void cull(std::shared_ptr<EngineCommandBuffer> commandBuffer, const GlobalUBO &ubo);
+
+			const std::vector<EngineDrawBucket>& getBuckets() const { return this->buckets; }
+			const EngineCullingStats& getStats() const { return this->stats; }
+
+			void bindInstances(std::shared_ptr<EngineCommandBuffer> commandBuffer);
+			void drawBucket(std::shared_ptr<EngineCommandBuffer> commandBuffer, const EngineDrawBucket &bucket);
+
+		private:
+			void createDescriptor();
+			void createObjectBuffer(uint32_t capacity);
+			void updateObjectData(EngineThreadPool &threadPool);
+			void createPipelineLayout();
+			void createPipelines();
+
+			struct DrawObject {
+				EngineEntity entity{};
+				uint32_t transformIndex = 0;
+				std::shared_ptr<EngineModel> model{};
+				std::shared_ptr<EngineTexture> texture{};
+				std::shared_ptr<VkDescriptorSet> textureDescSet{};
+			};
+
+			void collectObjects();
+			bool updatePendingObjects();
+			void rebuildDrawGroups();
+
+			EngineDevice& appDevice;
+			EngineDescriptorPool& descriptorPool;
+			EngineFrameAllocator& frameAllocator;
+
+			VkPipelineLayout pipelineLayout;
+			std::unique_ptr<EngineComputePipeline> cullPipeline;
+			std::unique_ptr<EngineComputePipeline> compactPipeline;
+
+			std::shared_ptr<EngineDescriptorSetLayout> cullDescSetLayout{};
+
+			// one set per frame in flight, so a grown object buffer is only written into sets the GPU is done with
+			std::vector<VkDescriptorSet> cullDescSets;
+			std::vector<VkBuffer> cullDescSetObjectBuffers;
+
+			// persistent CullObjectData of every draw object; only changed objects are copied in each frame
+			std::unique_ptr<EngineBuffer> objectBuffer;
+			std::vector<std::vector<std::unique_ptr<EngineBuffer>>> retiredObjectBuffers; // per frame index
+			bool isObjectBufferStale = true;
+
+			std::vector<uint32_t> transformObjects; // draw object of every transform index
+			std::vector<uint32_t> changedObjects;
+			std::vector<VkBufferCopy> objectCopies;
+			uint32_t frameIndex = 0;
+
+			EngineScene* scene = nullptr;
+			uint64_t modelsVersion = 0, texturesVersion = 0, transformsVersion = 0;
+
+			// renderables whose mesh or texture is still uploading
+			std::vector<DrawObject> pendingObjects;
+
+			// ready renderables, sorted so each draw group and bucket is contiguous
+			std::vector<DrawObject> drawObjects;
+			std::vector<uint32_t> objectGroups;
+			std::vector<CullDrawGroup> drawGroups;
+			std::vector<EngineDrawBucket> buckets;
+
+			// world space spheres for the CPU test split per component, refreshed with the object data
+			std::vector<float> sphereX, sphereY, sphereZ, sphereRadius;
+			std::vector<uint8_t> sphereVisible, boxVisible;
+
+			EngineCullingStats stats{};
+			bool useDrawIndirectCount = false;
+
+			// this frame's ranges in the frame allocator
+			VkDeviceSize visibleOffset = 0;
+			VkDeviceSize groupOffset = 0;
+			VkDeviceSize instanceOffset = 0;
+			VkDeviceSize countOffset = 0;
+			VkDeviceSize commandOffset = 0;
+	};
+}
@@ -0,0 +1,192 @@
+#include "light_cluster_system.hpp"
+#include "../swap_chain/swap_chain.hpp"
+
+#define GLM_FORCE_RADIANS
+#define GLM_FORCE_DEPTH_ZERO_TO_ONE
+#include <glm/glm.hpp>
+
+#include <stdexcept>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace nugiEngine {
+
+	// a light's range ends where it falls below this, the shaders fade it out up to there
+	constexpr float LIGHT_CUTOFF = 0.005f;
+
+	struct LightClusterPushConstant {
+		glm::mat4 view{1.0f};
+		glm::vec4 projection{0.0f}; // x & y scale of the projection, near, far
+	};
+
+	EngineLightClusterSystem::EngineLightClusterSystem(EngineDevice& device, EngineDescriptorPool &descriptorPool, EngineFrameAllocator &frameAllocator, EngineBuffer &clusterBuffer)
+		: appDevice{device}, frameAllocator{frameAllocator}, clusterBuffer{clusterBuffer}
+	{
+		this->createOverflowBuffer();
+		this->createDescriptor(descriptorPool);
+		this->createPipelineLayout();
+		this->createPipeline();
+	}
+
+	EngineLightClusterSystem::~EngineLightClusterSystem() {
+		vkDestroyPipelineLayout(this->appDevice.getLogicalDevice(), this->pipelineLayout, nullptr);
+	}
+
+	void EngineLightClusterSystem::createOverflowBuffer() {
+		this->overflowBuffer = std::make_unique<EngineBuffer>(
+			this->appDevice,
+			sizeof(LightClusterOverflow),
+			EngineSwapChain::MAX_FRAMES_IN_FLIGHT,
+			VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+			VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+			this->appDevice.getProperties().limits.minStorageBufferOffsetAlignment
+		);
+
+		this->overflowBuffer->map();
+		std::memset(this->overflowBuffer->getMappedMemory(), 0, this->overflowBuffer->getBufferSize());
+	}
+
+	void EngineLightClusterSystem::createDescriptor(EngineDescriptorPool &descriptorPool) {
+		this->clusterDescSetLayout =
+			EngineDescriptorSetLayout::Builder(this->appDevice)
+				.addBinding(0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC, VK_SHADER_STAGE_COMPUTE_BIT)
+				.addBinding(1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC, VK_SHADER_STAGE_COMPUTE_BIT)
+				.addBinding(2, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC, VK_SHADER_STAGE_COMPUTE_BIT)
+				.build();
+
+		// the lights, the cluster lists & the overflow each look at one frame's range of their buffers;
+		// the dynamic offsets pick this frame's ranges
+		auto lightBufferInfo = this->frameAllocator.descriptorInfo(LIGHT_BUFFER_RANGE);
+		auto clusterBufferInfo = this->clusterBuffer.descriptorInfo(sizeof(LightClusterData));
+		auto overflowBufferInfo = this->overflowBuffer->descriptorInfo(sizeof(LightClusterOverflow));
+
+		EngineDescriptorWriter(*this->clusterDescSetLayout, descriptorPool)
+			.writeBuffer(0, &lightBufferInfo)
+			.writeBuffer(1, &clusterBufferInfo)
+			.writeBuffer(2, &overflowBufferInfo)
+			.build(&this->clusterDescSet);
+	}
+
+	void EngineLightClusterSystem::createPipelineLayout() {
+		VkPushConstantRange pushConstantRange{};
+		pushConstantRange.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+		pushConstantRange.offset = 0;
+		pushConstantRange.size = sizeof(LightClusterPushConstant);
+
+		std::vector<VkDescriptorSetLayout> descriptorSetLayouts = { this->clusterDescSetLayout->getDescriptorSetLayout() };
+
+		VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
+		pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+		pipelineLayoutInfo.setLayoutCount = static_cast<uint32_t>(descriptorSetLayouts.size());
+		pipelineLayoutInfo.pSetLayouts = descriptorSetLayouts.data();
+		pipelineLayoutInfo.pushConstantRangeCount = 1;
+		pipelineLayoutInfo.pPushConstantRanges = &pushConstantRange;
+
+		if (vkCreatePipelineLayout(this->appDevice.getLogicalDevice(), &pipelineLayoutInfo, nullptr, &this->pipelineLayout) != VK_SUCCESS) {
+			throw std::runtime_error("failed to create pipeline layout!");
+		}
+	}
+
+	void EngineLightClusterSystem::createPipeline() {
+		assert(this->pipelineLayout != nullptr && "Cannot create pipeline before pipeline layout");
+		this->clusterPipeline = std::make_unique<EngineComputePipeline>(this->appDevice, this->pipelineLayout, "shader/light_cluster.comp.spv");
+	}
+
+	void EngineLightClusterSystem::prepare(FrameInfo &frameInfo, EngineScene &scene, VkExtent2D extent) {
+		// the fence of this frame index has signaled, so the pass that last wrote this slot is done
+		this->overflowOffset = static_cast<uint32_t>(frameInfo.frameIndex * this->overflowBuffer->getAlignmentSize());
+
+		auto frameOverflow = reinterpret_cast<LightClusterOverflow*>(static_cast<char*>(this->overflowBuffer->getMappedMemory()) + this->overflowOffset);
+		this->overflow = *frameOverflow;
+		*frameOverflow = LightClusterOverflow{};
+
+		auto& pointLights = scene.getPointLights();
+		auto& transforms = scene.getTransforms();
+
+		// the descriptors only see MAX_LIGHTS lights, the rest are left out
+		uint32_t maxLightCount = std::min(static_cast<uint32_t>(pointLights.size()), static_cast<uint32_t>(MAX_LIGHTS));
+
+		auto lightAllocation = this->frameAllocator.allocate(sizeof(GlobalLight) + sizeof(pointLight) * maxLightCount);
+		auto globalLight = static_cast<GlobalLight*>(lightAllocation.mapped);
+		auto lights = reinterpret_cast<pointLight*>(globalLight + 1);
+
+		uint32_t lightIndex = 0;
+
+		for (uint32_t i = 0; i < pointLights.size() && lightIndex < maxLightCount; i++) {
+			EngineEntity entity = pointLights.getEntities()[i];
+			if (!transforms.contains(entity)) continue;
+
+			auto& light = pointLights[i];
+			float peakIntensity = glm::max(glm::max(light.color.r, light.color.g), light.color.b) * light.lightIntensity;
+
+			glm::vec3 position = transforms.getModelMatrix(transforms.indexOf(entity))[3];
+			lights[lightIndex].position = glm::vec4{ position, std::sqrt(peakIntensity / LIGHT_CUTOFF) };
+			lights[lightIndex].color = glm::vec4{ light.color, light.lightIntensity };
+
+			lightIndex++;
+		}
+
+		// maps a fragment to its cluster: tile from the pixel, depth slice from log(view depth)
+		float depthLog = std::log(frameInfo.camera.getFar() / frameInfo.camera.getNear());
+
+		*globalLight = GlobalLight{};
+		globalLight->clusterParams = glm::vec4{
+			static_cast<float>(extent.width) / CLUSTER_GRID_X,
+			static_cast<float>(extent.height) / CLUSTER_GRID_Y,
+			CLUSTER_GRID_Z / depthLog,
+			-CLUSTER_GRID_Z * std::log(frameInfo.camera.getNear()) / depthLog
+		};
+		globalLight->numLights = lightIndex;
+
+		frameInfo.globalLightOffset = lightAllocation.dynamicOffset();
+		// this frame's slot of the cluster buffer, written entirely by the cluster pass
+		frameInfo.lightClusterOffset = static_cast<uint32_t>(frameInfo.frameIndex * this->clusterBuffer.getAlignmentSize());
+
+		this->lightCount = lightIndex;
+	}
+
+	void EngineLightClusterSystem::cluster(std::shared_ptr<EngineCommandBuffer> commandBuffer, FrameInfo &frameInfo) {
+		// ordered by binding number
+		uint32_t dynamicOffsets[] = { frameInfo.globalLightOffset, frameInfo.lightClusterOffset, this->overflowOffset };
+
+		vkCmdBindDescriptorSets(
+			commandBuffer->getCommandBuffer(),
+			VK_PIPELINE_BIND_POINT_COMPUTE,
+			this->pipelineLayout,
+			0,
+			1,
+			&this->clusterDescSet,
+			3,
+			dynamicOffsets
+		);
+
+		const glm::mat4 projection = frameInfo.camera.getProjectionMatrix();
+
+		LightClusterPushConstant pushConstant{};
+		pushConstant.view = frameInfo.camera.getViewMatrix();
+		pushConstant.projection = glm::vec4{ projection[0][0], projection[1][1], frameInfo.camera.getNear(), frameInfo.camera.getFar() };
+
+		vkCmdPushConstants(
+			commandBuffer->getCommandBuffer(),
+			this->pipelineLayout,
+			VK_SHADER_STAGE_COMPUTE_BIT,
+			0,
+			sizeof(LightClusterPushConstant),
+			&pushConstant
+		);
+
+		// one invocation per cluster, even without lights: every count has to be written
+		this->clusterPipeline->bind(commandBuffer->getCommandBuffer());
+		this->clusterPipeline->dispatch(commandBuffer->getCommandBuffer(), (CLUSTER_COUNT + 63) / 64);
+
+		VkMemoryBarrier barrier{};
+		barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+		barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+		barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_HOST_READ_BIT;
+
+		// the host reads the overflow once the frame's fence signaled
+		vkCmdPipelineBarrier(commandBuffer->getCommandBuffer(), VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 
+			VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_HOST_BIT, 0, 1, &barrier, 0, nullptr, 0, nullptr);
+	}
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include "../command/command_buffer.hpp"
+#include "../device/device.hpp"
+#include "../pipeline/compute_pipeline.hpp"
+#include "../scene/scene.hpp"
+#include "../frame_info.hpp"
+#include "../buffer/buffer.hpp"
+#include "../buffer/frame_allocator.hpp"
+#include "../descriptor/descriptor.hpp"
+#include "../globalUbo.hpp"
+
+#include <memory>
+#include <vector>
+
+namespace nugiEngine {
+	/**
+	 * Clustered forward lighting. Every point light of the scene goes into this frame's light buffer,
+	 * a compute pass bins them into a view space grid of screen tiles and exponential depth slices,
+	 * and the lit shaders only loop over the lights of their fragment's cluster.
+	 *
+	 * The cluster lists go to the renderer's device local cluster buffer. A cluster keeps at most
+	 * MAX_LIGHTS_PER_CLUSTER lights; the pass counts the clusters that had more, see getOverflow().
+	 */
+	class EngineLightClusterSystem {
+		public:
+			EngineLightClusterSystem(EngineDevice& device, EngineDescriptorPool &descriptorPool, EngineFrameAllocator &frameAllocator, EngineBuffer &clusterBuffer);
+			~EngineLightClusterSystem();
+
+			EngineLightClusterSystem(const EngineLightClusterSystem&) = delete;
+			EngineLightClusterSystem& operator = (const EngineLightClusterSystem&) = delete;
+
+			// writes the light buffer, sets the frame's globalLightOffset & lightClusterOffset and reads back the
+			// overflow of the frame that last used this frame index. The scene's transform matrices must be up to date
+			void prepare(FrameInfo &frameInfo, EngineScene &scene, VkExtent2D extent);
+
+			// records the binning dispatch for the last prepare, must be called outside of a render pass
+			void cluster(std::shared_ptr<EngineCommandBuffer> commandBuffer, FrameInfo &frameInfo);
+
+			uint32_t getLightCount() const { return this->lightCount; }
+
+			// clusters that dropped lights, MAX_FRAMES_IN_FLIGHT frames late
+			const LightClusterOverflow& getOverflow() const { return this->overflow; }
+
+		private:
+			void createOverflowBuffer();
+			void createDescriptor(EngineDescriptorPool &descriptorPool);
+			void createPipelineLayout();
+			void createPipeline();
+
+			EngineDevice& appDevice;
+			EngineFrameAllocator& frameAllocator;
+			EngineBuffer& clusterBuffer;
+
+			// one host visible LightClusterOverflow per frame in flight
+			std::unique_ptr<EngineBuffer> overflowBuffer;
+			LightClusterOverflow overflow{};
+			uint32_t overflowOffset = 0;
+
+			VkPipelineLayout pipelineLayout;
+			std::unique_ptr<EngineComputePipeline> clusterPipeline;
+
+			std::shared_ptr<EngineDescriptorSetLayout> clusterDescSetLayout{};
+			VkDescriptorSet clusterDescSet;
+
+			uint32_t lightCount = 0;
+	};
+}
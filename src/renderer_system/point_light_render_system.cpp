@@ -6,16 +6,32 @@
 #define GLM_FORCE_DEPTH_ZERO_TO_ONE
 #include <glm/glm.hpp>
 #include <glm/gtc/constants.hpp>
+#include <glm/gtc/matrix_transform.hpp>
 
 #include <stdexcept>
 #include <array>
 #include <string>
 
 namespace nugiEngine {
-	struct PointLightPushConstant {
-		glm::vec4 position{};
+	// one billboard, read per instance by point_light_shader.vert
+	struct PointLightInstance {
+		glm::vec4 position{}; // w: billboard radius
 		glm::vec4 color{};
-		float radius;
+
+		static std::vector<VkVertexInputBindingDescription> getInstanceBindingDescriptions() {
+			std::vector<VkVertexInputBindingDescription> bindingDescriptions(1);
+			bindingDescriptions[0].binding = 0;
+			bindingDescriptions[0].stride = sizeof(PointLightInstance);
+			bindingDescriptions[0].inputRate = VK_VERTEX_INPUT_RATE_INSTANCE;
+			return bindingDescriptions;
+		}
+
+		static std::vector<VkVertexInputAttributeDescription> getInstanceAttributeDescriptions() {
+			std::vector<VkVertexInputAttributeDescription> attributeDescriptions(2);
+			attributeDescriptions[0] = { 0, 0, VK_FORMAT_R32G32B32A32_SFLOAT, offsetof(PointLightInstance, position) };
+			attributeDescriptions[1] = { 1, 0, VK_FORMAT_R32G32B32A32_SFLOAT, offsetof(PointLightInstance, color) };
+			return attributeDescriptions;
+		}
 	};
 	
 	EnginePointLightRenderSystem::EnginePointLightRenderSystem(EngineDevice& device, VkRenderPass renderPass, VkDescriptorSetLayout globalDescSetLayout) : appDevice{device} {
@@ -28,19 +44,14 @@ namespace nugiEngine {
 	}
 
 	void EnginePointLightRenderSystem::createPipelineLayout(VkDescriptorSetLayout globalDescSetLayout) {
-		VkPushConstantRange pushConstantRange{};
-		pushConstantRange.stageFlags = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT;
-		pushConstantRange.offset = 0;
-		pushConstantRange.size = sizeof(PointLightPushConstant);
-
 		std::vector<VkDescriptorSetLayout> descriptorSetLayouts = { globalDescSetLayout };
 
 		VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
 		pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
 		pipelineLayoutInfo.setLayoutCount = static_cast<uint32_t>(descriptorSetLayouts.size());
 		pipelineLayoutInfo.pSetLayouts = descriptorSetLayouts.data();
-		pipelineLayoutInfo.pushConstantRangeCount = 1;
-		pipelineLayoutInfo.pPushConstantRanges = &pushConstantRange;
+		pipelineLayoutInfo.pushConstantRangeCount = 0;
+		pipelineLayoutInfo.pPushConstantRanges = nullptr;
 
 		if (vkCreatePipelineLayout(this->appDevice.getLogicalDevice(), &pipelineLayoutInfo, nullptr, &this->pipelineLayout) != VK_SUCCESS) {
 			throw std::runtime_error("failed to create pipeline layout!");
@@ -52,34 +63,54 @@ namespace nugiEngine {
 
 		this->pipeline = EnginePipeline::Builder(this->appDevice, this->pipelineLayout, renderPass)
 			.setDefault("shader/point_light.vert.spv", "shader/point_light.frag.spv")
-			.setBindingDescriptions({})
-			.setAttributeDescriptions({})
+			.setBindingDescriptions(PointLightInstance::getInstanceBindingDescriptions())
+			.setAttributeDescriptions(PointLightInstance::getInstanceAttributeDescriptions())
 			.build();
 	}
 
-	void EnginePointLightRenderSystem::update(FrameInfo &frameInfo, std::vector<std::shared_ptr<EngineGameObject>> &pointLightObjects, GlobalLight &globalLight) {
+	void EnginePointLightRenderSystem::update(FrameInfo &frameInfo, EngineScene &scene) {
 		auto rotateLight = glm::rotate(glm::mat4(1.f), 0.5f * frameInfo.frameTime, {0.f, -1.f, 0.f});
-		int lightIndex = 0;
+		auto& pointLights = scene.getPointLights();
+		auto& transforms = scene.getTransforms();
+
+		for (uint32_t i = 0; i < pointLights.size(); i++) {
+			EngineEntity entity = pointLights.getEntities()[i];
+			if (!transforms.contains(entity)) continue;
+
+			// update light position, relative to its parent if it has one
+			uint32_t transformIndex = transforms.indexOf(entity);
+			transforms.setTranslation(transformIndex, glm::vec3(rotateLight * glm::vec4(transforms.getTranslation(transformIndex), 1.f)));
+		}
+	}
 
-		for (auto& plo : pointLightObjects) {
-			if (plo->pointLights == nullptr) continue;
+	void EnginePointLightRenderSystem::render(std::shared_ptr<EngineCommandBuffer> commandBuffer, VkDescriptorSet &UBODescSet, FrameInfo &frameInfo, EngineScene &scene) {
+		auto& pointLights = scene.getPointLights();
+		auto& transforms = scene.getTransforms();
 
-			// update light position
-     	plo->transform.translation = glm::vec3(rotateLight * glm::vec4(plo->transform.translation, 1.f));
+		if (pointLights.size() == 0) return;
 
-			// copy light to ubo
-			globalLight.pointLights[lightIndex].position = glm::vec4{ plo->transform.translation, 1.0f };
-			globalLight.pointLights[lightIndex].color = glm::vec4{ plo->color, plo->pointLights->lightIntensity };
+		// every billboard of the frame goes into one instance range, drawn with a single call
+		auto instanceAllocation = frameInfo.frameAllocator->allocate(sizeof(PointLightInstance) * pointLights.size());
+		auto instances = static_cast<PointLightInstance*>(instanceAllocation.mapped);
+		uint32_t instanceCount = 0;
 
-			lightIndex++;
+		for (uint32_t i = 0; i < pointLights.size(); i++) {
+			EngineEntity entity = pointLights.getEntities()[i];
+			if (!transforms.contains(entity)) continue;
+
+			glm::vec3 position = transforms.getModelMatrix(transforms.indexOf(entity))[3];
+			instances[instanceCount].position = glm::vec4{ position, pointLights[i].radius };
+			instances[instanceCount].color = glm::vec4{ pointLights[i].color, pointLights[i].lightIntensity };
+
+			instanceCount++;
 		}
 
-		globalLight.numLights = lightIndex;
-	}
+		if (instanceCount == 0) return;
 
-	void EnginePointLightRenderSystem::render(std::shared_ptr<EngineCommandBuffer> commandBuffer, VkDescriptorSet &UBODescSet, FrameInfo &frameInfo, std::vector<std::shared_ptr<EngineGameObject>> &pointLightObjects) {
 		this->pipeline->bind(commandBuffer->getCommandBuffer());
 
+		uint32_t dynamicOffsets[] = { frameInfo.globalUboOffset, frameInfo.globalLightOffset, frameInfo.lightClusterOffset };
+
 		vkCmdBindDescriptorSets(
 			commandBuffer->getCommandBuffer(),
 			VK_PIPELINE_BIND_POINT_GRAPHICS,
@@ -87,28 +118,14 @@ namespace nugiEngine {
 			0,
 			1,
 			&UBODescSet,
-			0,
-			nullptr
+			3,
+			dynamicOffsets
 		);
 
-		for (auto& plo : pointLightObjects) {
-			if (plo->pointLights == nullptr) continue;
-
-			PointLightPushConstant pushConstant{};
-			pushConstant.position = glm::vec4{ plo->transform.translation, 1.0f };
-			pushConstant.color = glm::vec4{ plo->color, plo->pointLights->lightIntensity };
-			pushConstant.radius = plo->transform.scale.x;
+		VkBuffer instanceBuffers[] = { frameInfo.frameAllocator->getBuffer() };
+		VkDeviceSize instanceOffsets[] = { instanceAllocation.offset };
+		vkCmdBindVertexBuffers(commandBuffer->getCommandBuffer(), 0, 1, instanceBuffers, instanceOffsets);
 
-			vkCmdPushConstants(
-				commandBuffer->getCommandBuffer(),
-				this->pipelineLayout,
-				VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT,
-				0,
-				sizeof(PointLightPushConstant),
-				&pushConstant
-			);
-
-			vkCmdDraw(commandBuffer->getCommandBuffer(), 6, 1, 0, 0);
-		}
+		vkCmdDraw(commandBuffer->getCommandBuffer(), 6, instanceCount, 0, 0);
 	}
 }
\ No newline at end of file
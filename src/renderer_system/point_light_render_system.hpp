@@ -4,7 +4,7 @@
 #include "../camera/camera.hpp"
 #include "../device/device.hpp"
 #include "../pipeline/pipeline.hpp"
-#include "../game_object/game_object.hpp"
+#include "../scene/scene.hpp"
 #include "../frame_info.hpp"
 #include "../buffer/buffer.hpp"
 #include "../descriptor/descriptor.hpp"
@@ -22,8 +22,8 @@ namespace nugiEngine {
 			EnginePointLightRenderSystem(const EnginePointLightRenderSystem&) = delete;
 			EnginePointLightRenderSystem& operator = (const EnginePointLightRenderSystem&) = delete;
 
-			void update(FrameInfo &frameInfo, std::vector<std::shared_ptr<EngineGameObject>> &pointLightObjects, GlobalLight &globalLight);
-			void render(std::shared_ptr<EngineCommandBuffer> commandBuffer, VkDescriptorSet &UBODescSet, FrameInfo &frameInfo, std::vector<std::shared_ptr<EngineGameObject>> &pointLightObjects);
+			void update(FrameInfo &frameInfo, EngineScene &scene);
+			void render(std::shared_ptr<EngineCommandBuffer> commandBuffer, VkDescriptorSet &UBODescSet, FrameInfo &frameInfo, EngineScene &scene);
 
 		private:
 			void createPipelineLayout(VkDescriptorSetLayout globalDescSetLayout);
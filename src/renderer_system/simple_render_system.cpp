@@ -13,11 +13,6 @@
 
 namespace nugiEngine {
 
-	struct SimplePushConstantData {
-		glm::mat4 modelMatrix{1.0f};
-		glm::mat4 normalMatrix{1.0f};
-	};
-
 	EngineSimpleRenderSystem::EngineSimpleRenderSystem(EngineDevice& device, VkRenderPass renderPass, VkDescriptorSetLayout globalDescSetLayout) : appDevice{device} {
 		this->createPipelineLayout(globalDescSetLayout);
 		this->createPipeline(renderPass);
@@ -28,19 +23,14 @@ namespace nugiEngine {
 	}
 
 	void EngineSimpleRenderSystem::createPipelineLayout(VkDescriptorSetLayout globalDescSetLayout) {
-		VkPushConstantRange pushConstantRange{};
-		pushConstantRange.stageFlags = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT;
-		pushConstantRange.offset = 0;
-		pushConstantRange.size = sizeof(SimplePushConstantData);
-
 		std::vector<VkDescriptorSetLayout> descriptorSetLayouts = { globalDescSetLayout };
 
 		VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
 		pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
 		pipelineLayoutInfo.setLayoutCount = static_cast<uint32_t>(descriptorSetLayouts.size());
 		pipelineLayoutInfo.pSetLayouts = descriptorSetLayouts.data();
-		pipelineLayoutInfo.pushConstantRangeCount = 1;
-		pipelineLayoutInfo.pPushConstantRanges = &pushConstantRange;
+		pipelineLayoutInfo.pushConstantRangeCount = 0;
+		pipelineLayoutInfo.pPushConstantRanges = nullptr;
 
 		if (vkCreatePipelineLayout(this->appDevice.getLogicalDevice(), &pipelineLayoutInfo, nullptr, &this->pipelineLayout) != VK_SUCCESS) {
 			throw std::runtime_error("failed to create pipeline layout!");
@@ -50,14 +40,26 @@ namespace nugiEngine {
 	void EngineSimpleRenderSystem::createPipeline(VkRenderPass renderPass) {
 		assert(this->pipelineLayout != nullptr && "Cannot create pipeline before pipeline layout");
 
+		auto bindingDescriptions = Vertex::getVertexBindingDescriptions();
+		auto instanceBindingDescriptions = InstanceData::getInstanceBindingDescriptions();
+		bindingDescriptions.insert(bindingDescriptions.end(), instanceBindingDescriptions.begin(), instanceBindingDescriptions.end());
+
+		auto attributeDescriptions = Vertex::getVertexAttributeDescriptions();
+		auto instanceAttributeDescriptions = InstanceData::getInstanceAttributeDescriptions();
+		attributeDescriptions.insert(attributeDescriptions.end(), instanceAttributeDescriptions.begin(), instanceAttributeDescriptions.end());
+
 		this->pipeline = EnginePipeline::Builder(this->appDevice, this->pipelineLayout, renderPass)
 			.setDefault("shader/simple_shader.vert.spv", "shader/simple_shader.frag.spv")
+			.setBindingDescriptions(bindingDescriptions)
+			.setAttributeDescriptions(attributeDescriptions)
 			.build();
 	}
 
-	void EngineSimpleRenderSystem::render(std::shared_ptr<EngineCommandBuffer> commandBuffer, VkDescriptorSet &UBODescSet, FrameInfo &frameInfo, std::vector<std::shared_ptr<EngineGameObject>> &gameObjects) {
+	void EngineSimpleRenderSystem::render(std::shared_ptr<EngineCommandBuffer> commandBuffer, VkDescriptorSet &UBODescSet, FrameInfo &frameInfo, EngineCullingSystem &cullingSystem) {
 		this->pipeline->bind(commandBuffer->getCommandBuffer());
 
+		uint32_t dynamicOffsets[] = { frameInfo.globalUboOffset, frameInfo.globalLightOffset, frameInfo.lightClusterOffset };
+
 		vkCmdBindDescriptorSets(
 			commandBuffer->getCommandBuffer(),
 			VK_PIPELINE_BIND_POINT_GRAPHICS,
@@ -65,29 +67,23 @@ namespace nugiEngine {
 			0,
 			1,
 			&UBODescSet,
-			0,
-			nullptr
+			3,
+			dynamicOffsets
 		);
 
-		for (auto& obj : gameObjects) {
-			if (obj->textureDescSet != nullptr || obj->pointLights != nullptr) continue;
-			
-			SimplePushConstantData pushConstant{};
-
-			pushConstant.modelMatrix = obj->transform.mat4();
-			pushConstant.normalMatrix = obj->transform.normalMatrix();
-
-			vkCmdPushConstants(
-				commandBuffer->getCommandBuffer(), 
-				pipelineLayout, 
-				VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT,
-				0,
-				sizeof(SimplePushConstantData),
-				&pushConstant
-			);
-
-			obj->model->bind(commandBuffer);
-			obj->model->draw(commandBuffer);
+		cullingSystem.bindInstances(commandBuffer);
+
+		EngineGeometryPool* boundPool = nullptr;
+
+		for (auto& bucket : cullingSystem.getBuckets()) {
+			if (bucket.textureDescSet != nullptr) continue;
+
+			if (bucket.geometryPool != boundPool) {
+				bucket.geometryPool->bind(commandBuffer);
+				boundPool = bucket.geometryPool;
+			}
+
+			cullingSystem.drawBucket(commandBuffer, bucket);
 		}
 	}
 }
\ No newline at end of file
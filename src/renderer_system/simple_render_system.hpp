@@ -5,6 +5,7 @@
 #include "../device/device.hpp"
 #include "../pipeline/pipeline.hpp"
 #include "../game_object/game_object.hpp"
+#include "culling_system.hpp"
 #include "../frame_info.hpp"
 #include "../buffer/buffer.hpp"
 #include "../descriptor/descriptor.hpp"
@@ -22,7 +23,7 @@ namespace nugiEngine {
 			EngineSimpleRenderSystem(const EngineSimpleRenderSystem&) = delete;
 			EngineSimpleRenderSystem& operator = (const EngineSimpleRenderSystem&) = delete;
 
-			void render(std::shared_ptr<EngineCommandBuffer> commandBuffer, VkDescriptorSet &UBODescSet, FrameInfo &frameInfo, std::vector<std::shared_ptr<EngineGameObject>> &gameObjects);
+			void render(std::shared_ptr<EngineCommandBuffer> commandBuffer, VkDescriptorSet &UBODescSet, FrameInfo &frameInfo, EngineCullingSystem &cullingSystem);
 
 		private:
 			void createPipelineLayout(VkDescriptorSetLayout globalDescSetLayouts);
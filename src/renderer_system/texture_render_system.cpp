@@ -13,11 +13,6 @@
 
 namespace nugiEngine {
 
-	struct SimplePushConstantData {
-		glm::mat4 modelMatrix{1.0f};
-		glm::mat4 normalMatrix{1.0f};
-	};
-
 	EngineTextureRenderSystem::EngineTextureRenderSystem(EngineDevice& device, VkRenderPass renderPass, VkDescriptorSetLayout globalDescSetLayout) 
 		: appDevice{device} 
 	{
@@ -38,19 +33,14 @@ namespace nugiEngine {
 	}
 
 	void EngineTextureRenderSystem::createPipelineLayout(VkDescriptorSetLayout globalDescSetLayout) {
-		VkPushConstantRange pushConstantRange{};
-		pushConstantRange.stageFlags = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT;
-		pushConstantRange.offset = 0;
-		pushConstantRange.size = sizeof(SimplePushConstantData);
-
 		std::vector<VkDescriptorSetLayout> descriptorSetLayouts = { globalDescSetLayout, this->textureDescSetLayout->getDescriptorSetLayout() };
 
 		VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
 		pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
 		pipelineLayoutInfo.setLayoutCount = static_cast<uint32_t>(descriptorSetLayouts.size());
 		pipelineLayoutInfo.pSetLayouts = descriptorSetLayouts.data();
-		pipelineLayoutInfo.pushConstantRangeCount = 1;
-		pipelineLayoutInfo.pPushConstantRanges = &pushConstantRange;
+		pipelineLayoutInfo.pushConstantRangeCount = 0;
+		pipelineLayoutInfo.pPushConstantRanges = nullptr;
 
 		if (vkCreatePipelineLayout(this->appDevice.getLogicalDevice(), &pipelineLayoutInfo, nullptr, &this->pipelineLayout) != VK_SUCCESS) {
 			throw std::runtime_error("failed to create pipeline layout!");
@@ -60,8 +50,18 @@ namespace nugiEngine {
 	void EngineTextureRenderSystem::createPipeline(VkRenderPass renderPass) {
 		assert(this->pipelineLayout != nullptr && "Cannot create pipeline before pipeline layout");
 
+		auto bindingDescriptions = Vertex::getVertexBindingDescriptions();
+		auto instanceBindingDescriptions = InstanceData::getInstanceBindingDescriptions();
+		bindingDescriptions.insert(bindingDescriptions.end(), instanceBindingDescriptions.begin(), instanceBindingDescriptions.end());
+
+		auto attributeDescriptions = Vertex::getVertexAttributeDescriptions();
+		auto instanceAttributeDescriptions = InstanceData::getInstanceAttributeDescriptions();
+		attributeDescriptions.insert(attributeDescriptions.end(), instanceAttributeDescriptions.begin(), instanceAttributeDescriptions.end());
+
 		this->pipeline = EnginePipeline::Builder(this->appDevice, this->pipelineLayout, renderPass)
 			.setDefault("shader/simple_texture_shader.vert.spv", "shader/simple_texture_shader.frag.spv")
+			.setBindingDescriptions(bindingDescriptions)
+			.setAttributeDescriptions(attributeDescriptions)
 			.build();
 	}
 
@@ -75,13 +75,18 @@ namespace nugiEngine {
 		return descSet;
 	}
 
-	void EngineTextureRenderSystem::render(std::shared_ptr<EngineCommandBuffer> commandBuffer, VkDescriptorSet &UBODescSet, FrameInfo &frameInfo, std::vector<std::shared_ptr<EngineGameObject>> &gameObjects) {
+	void EngineTextureRenderSystem::render(std::shared_ptr<EngineCommandBuffer> commandBuffer, VkDescriptorSet &UBODescSet, FrameInfo &frameInfo, EngineCullingSystem &cullingSystem) {
 		this->pipeline->bind(commandBuffer->getCommandBuffer());
+		uint32_t dynamicOffsets[] = { frameInfo.globalUboOffset, frameInfo.globalLightOffset, frameInfo.lightClusterOffset };
+
+		cullingSystem.bindInstances(commandBuffer);
+
+		EngineGeometryPool* boundPool = nullptr;
 
-		for (auto& obj : gameObjects) {
-			if (obj->textureDescSet == nullptr) continue;
-			
-			VkDescriptorSet descpSet[2] = { UBODescSet, *obj->textureDescSet };
+		for (auto& bucket : cullingSystem.getBuckets()) {
+			if (bucket.textureDescSet == nullptr) continue;
+
+			VkDescriptorSet descpSet[2] = { UBODescSet, *bucket.textureDescSet };
 
 			vkCmdBindDescriptorSets(
 				commandBuffer->getCommandBuffer(),
@@ -90,26 +95,16 @@ namespace nugiEngine {
 				0,
 				2,
 				descpSet,
-				0,
-				nullptr
+				3,
+				dynamicOffsets
 			);
 
-			SimplePushConstantData pushConstant{};
-
-			pushConstant.modelMatrix = obj->transform.mat4();
-			pushConstant.normalMatrix = obj->transform.normalMatrix();
-
-			vkCmdPushConstants(
-				commandBuffer->getCommandBuffer(), 
-				this->pipelineLayout, 
-				VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT,
-				0,
-				sizeof(SimplePushConstantData),
-				&pushConstant
-			);
+			if (bucket.geometryPool != boundPool) {
+				bucket.geometryPool->bind(commandBuffer);
+				boundPool = bucket.geometryPool;
+			}
 
-			obj->model->bind(commandBuffer);
-			obj->model->draw(commandBuffer);
+			cullingSystem.drawBucket(commandBuffer, bucket);
 		}
 	}
 }
\ No newline at end of file
@@ -5,6 +5,7 @@
 #include "../device/device.hpp"
 #include "../pipeline/pipeline.hpp"
 #include "../game_object/game_object.hpp"
+#include "culling_system.hpp"
 #include "../frame_info.hpp"
 #include "../buffer/buffer.hpp"
 #include "../descriptor/descriptor.hpp"
@@ -24,7 +25,7 @@ namespace nugiEngine {
 			EngineTextureRenderSystem& operator = (const EngineTextureRenderSystem&) = delete;
 			
 			std::shared_ptr<VkDescriptorSet> setupTextureDescriptorSet(EngineDescriptorPool &descriptorPool, VkDescriptorImageInfo descImageInfo);
-			void render(std::shared_ptr<EngineCommandBuffer> commandBuffer, VkDescriptorSet &UBODescSet, FrameInfo &frameInfo, std::vector<std::shared_ptr<EngineGameObject>> &gameObjects);
+			void render(std::shared_ptr<EngineCommandBuffer> commandBuffer, VkDescriptorSet &UBODescSet, FrameInfo &frameInfo, EngineCullingSystem &cullingSystem);
 
 		private:
 			void createDescriptor();
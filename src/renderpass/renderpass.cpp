@@ -48,11 +48,21 @@ namespace nugiEngine {
   }
 
   EngineRenderPass::~EngineRenderPass() {
+    this->destroyFramebuffers();
+    vkDestroyRenderPass(this->appDevice.getLogicalDevice(), this->renderPass, nullptr);
+  }
+
+  void EngineRenderPass::destroyFramebuffers() {
     for (auto framebuffer : this->framebuffers) {
       vkDestroyFramebuffer(this->appDevice.getLogicalDevice(), framebuffer, nullptr);
     }
 
-    vkDestroyRenderPass(this->appDevice.getLogicalDevice(), this->renderPass, nullptr);
+    this->framebuffers.clear();
+  }
+
+  void EngineRenderPass::recreateFramebuffers(std::vector<std::vector<VkImageView>> viewImages, int width, int height) {
+    this->destroyFramebuffers();
+    this->createFramebuffers(viewImages, width, height);
   }
   
   void EngineRenderPass::createRenderPass(VkRenderPassCreateInfo renderPassInfo) {
@@ -39,6 +39,9 @@ namespace nugiEngine {
       VkFramebuffer getFramebuffers(int index) { return this->framebuffers[index]; }
       VkRenderPass getRenderPass() { return this->renderPass; }
 
+      // new attachments of the same formats, e.g. after a resize; the render pass itself is kept
+      void recreateFramebuffers(std::vector<std::vector<VkImageView>> viewImages, int width, int height);
+
     private:
       EngineDevice &appDevice;
 
@@ -47,6 +50,7 @@ namespace nugiEngine {
 
       void createRenderPass(VkRenderPassCreateInfo renderPassInfo);
       void createFramebuffers(std::vector<std::vector<VkImageView>> viewImages, int width, int height);
+      void destroyFramebuffers();
   };
 } // namespace nugiEngin 
 
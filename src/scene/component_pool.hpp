@@ -0,0 +1,115 @@
+#pragma once
+
+// std lib headers
+#include <cassert>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace nugiEngine {
+  // An index into the scene's entity slots plus the generation of that slot, so a handle to a
+  // destroyed entity never matches whatever reuses its slot later
+  struct EngineEntity {
+    static constexpr uint32_t INVALID_INDEX = std::numeric_limits<uint32_t>::max();
+
+    uint32_t index = INVALID_INDEX;
+    uint32_t generation = 0;
+
+    bool isValid() const { return this->index != INVALID_INDEX; }
+
+    bool operator==(const EngineEntity &other) const { return this->index == other.index && this->generation == other.generation; }
+    bool operator!=(const EngineEntity &other) const { return !(*this == other); }
+  };
+
+  /**
+   * Sparse set: maps entity indices to a dense range [0, size()). Removing swaps the last element
+   * into the hole, so the dense arrays of the pools built on top never have gaps.
+   */
+  class EngineSparseSet {
+    public:
+      bool contains(EngineEntity entity) const {
+        return entity.index < this->sparse.size() && this->sparse[entity.index] < this->dense.size() 
+          && this->dense[this->sparse[entity.index]] == entity;
+      }
+
+      uint32_t indexOf(EngineEntity entity) const {
+        assert(this->contains(entity) && "entity does not have this component");
+        return this->sparse[entity.index];
+      }
+
+      uint32_t size() const { return static_cast<uint32_t>(this->dense.size()); }
+      const std::vector<EngineEntity>& getEntities() const { return this->dense; }
+
+      // bumped every time an entity is added or removed, not when a component is only modified
+      uint64_t getVersion() const { return this->version; }
+
+    protected:
+      uint32_t insertEntity(EngineEntity entity) {
+        if (entity.index >= this->sparse.size()) {
+          this->sparse.resize(entity.index + 1, EngineEntity::INVALID_INDEX);
+        }
+
+        uint32_t denseIndex = this->size();
+        this->sparse[entity.index] = denseIndex;
+        this->dense.push_back(entity);
+        this->version++;
+
+        return denseIndex;
+      }
+
+      // returns the dense index that was freed; the caller moves its last element there
+      uint32_t eraseEntity(EngineEntity entity) {
+        uint32_t denseIndex = this->indexOf(entity);
+        EngineEntity last = this->dense.back();
+
+        this->dense[denseIndex] = last;
+        this->sparse[last.index] = denseIndex;
+        this->sparse[entity.index] = EngineEntity::INVALID_INDEX;
+        this->dense.pop_back();
+        this->version++;
+
+        return denseIndex;
+      }
+
+      std::vector<uint32_t> sparse;
+      std::vector<EngineEntity> dense;
+      uint64_t version = 0;
+  };
+
+  // One component type for every entity that has it, stored contiguously in entity insertion order
+  template<typename T>
+  class EngineComponentPool : public EngineSparseSet {
+    public:
+      T& add(EngineEntity entity, T component) {
+        if (this->contains(entity)) {
+          return this->components[this->indexOf(entity)] = std::move(component);
+        }
+
+        this->insertEntity(entity);
+        this->components.push_back(std::move(component));
+
+        return this->components.back();
+      }
+
+      void remove(EngineEntity entity) {
+        if (!this->contains(entity)) return;
+
+        uint32_t denseIndex = this->eraseEntity(entity);
+        if (denseIndex + 1 != this->components.size()) {
+          this->components[denseIndex] = std::move(this->components.back());
+        }
+
+        this->components.pop_back();
+      }
+
+      T* get(EngineEntity entity) { return this->contains(entity) ? &this->components[this->indexOf(entity)] : nullptr; }
+
+      T& operator[](uint32_t denseIndex) { return this->components[denseIndex]; }
+      std::vector<T>& getComponents() { return this->components; }
+
+    private:
+      std::vector<T> components;
+  };
+  
+} // namespace nugiEngine
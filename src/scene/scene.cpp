@@ -0,0 +1,36 @@
+#include "scene.hpp"
+
+namespace nugiEngine {
+  EngineEntity EngineScene::createEntity() {
+    EngineEntity entity{};
+
+    if (!this->freeIndices.empty()) {
+      entity.index = this->freeIndices.back();
+      this->freeIndices.pop_back();
+    } else {
+      entity.index = static_cast<uint32_t>(this->generations.size());
+      this->generations.push_back(0);
+    }
+
+    entity.generation = this->generations[entity.index];
+    return entity;
+  }
+
+  void EngineScene::destroyEntity(EngineEntity entity) {
+    if (!this->isAlive(entity)) return;
+
+    this->transforms.remove(entity);
+    this->models.remove(entity);
+    this->textures.remove(entity);
+    this->pointLights.remove(entity);
+
+    // handles still pointing at the old generation stop matching
+    this->generations[entity.index]++;
+    this->freeIndices.push_back(entity.index);
+  }
+
+  bool EngineScene::isAlive(EngineEntity entity) const {
+    return entity.index < this->generations.size() && this->generations[entity.index] == entity.generation;
+  }
+  
+} // namespace nugiEngine
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "component_pool.hpp"
+#include "transform_pool.hpp"
+#include "../model/model.hpp"
+#include "../texture/texture.hpp"
+
+#define GLM_FORCE_RADIANS
+#define GLM_FORCE_DEPTH_ZERO_TO_ONE
+#include <glm/glm.hpp>
+
+// std lib headers
+#include <memory>
+#include <vector>
+
+namespace nugiEngine {
+  struct ModelComponent {
+    std::shared_ptr<EngineModel> model{};
+  };
+
+  struct TextureComponent {
+    std::shared_ptr<EngineTexture> texture{};
+    std::shared_ptr<VkDescriptorSet> textureDescSet{};
+  };
+
+  // the light sits at its entity's translation
+  struct PointLightComponent {
+    glm::vec3 color{1.0f};
+    float lightIntensity = 1.0f;
+    float radius = 1.0f;
+  };
+
+  /**
+   * Entities are only handles; their data lives in one dense pool per component type. Systems walk
+   * the pool of the component they care about instead of every entity in the scene.
+   */
+  class EngineScene {
+    public:
+      EngineScene() = default;
+
+      EngineScene(const EngineScene&) = delete;
+      EngineScene& operator = (const EngineScene&) = delete;
+
+      EngineEntity createEntity();
+      void destroyEntity(EngineEntity entity);
+      bool isAlive(EngineEntity entity) const;
+
+      EngineTransformPool& getTransforms() { return this->transforms; }
+      EngineComponentPool<ModelComponent>& getModels() { return this->models; }
+      EngineComponentPool<TextureComponent>& getTextures() { return this->textures; }
+      EngineComponentPool<PointLightComponent>& getPointLights() { return this->pointLights; }
+
+    private:
+      std::vector<uint32_t> generations;
+      std::vector<uint32_t> freeIndices;
+
+      EngineTransformPool transforms;
+      EngineComponentPool<ModelComponent> models;
+      EngineComponentPool<TextureComponent> textures;
+      EngineComponentPool<PointLightComponent> pointLights;
+  };
+  
+} // namespace nugiEngine
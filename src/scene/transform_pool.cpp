@@ -0,0 +1,272 @@
+#include "transform_pool.hpp"
+
+// std headers
+#include <algorithm>
+#include <cassert>
+
+namespace nugiEngine {
+  void EngineTransformPool::add(EngineEntity entity, glm::vec3 translation, glm::vec3 rotation, glm::vec3 scale) {
+    if (!this->contains(entity)) {
+      this->insertEntity(entity);
+
+      this->translationX.push_back(0.0f); this->translationY.push_back(0.0f); this->translationZ.push_back(0.0f);
+      this->rotationX.push_back(0.0f); this->rotationY.push_back(0.0f); this->rotationZ.push_back(0.0f);
+      this->scaleX.push_back(1.0f); this->scaleY.push_back(1.0f); this->scaleZ.push_back(1.0f);
+
+      this->parents.emplace_back();
+
+      this->localMatrices.emplace_back(1.0f);
+      this->localNormalMatrices.emplace_back(1.0f);
+      this->dirty.push_back(0);
+
+      this->isHierarchyChanged = true;
+    }
+
+    uint32_t index = this->indexOf(entity);
+
+    this->setTranslation(index, translation);
+    this->setRotation(index, rotation);
+    this->setScale(index, scale);
+  }
+
+  void EngineTransformPool::remove(EngineEntity entity) {
+    if (!this->contains(entity)) return;
+
+    uint32_t index = this->eraseEntity(entity);
+    uint32_t last = static_cast<uint32_t>(this->dirty.size() - 1);
+
+    if (this->dirty[index]) this->dirtyCount--;
+
+    if (index != last) {
+      this->translationX[index] = this->translationX[last]; this->translationY[index] = this->translationY[last]; this->translationZ[index] = this->translationZ[last];
+      this->rotationX[index] = this->rotationX[last]; this->rotationY[index] = this->rotationY[last]; this->rotationZ[index] = this->rotationZ[last];
+      this->scaleX[index] = this->scaleX[last]; this->scaleY[index] = this->scaleY[last]; this->scaleZ[index] = this->scaleZ[last];
+
+      this->parents[index] = this->parents[last];
+
+      this->localMatrices[index] = this->localMatrices[last];
+      this->localNormalMatrices[index] = this->localNormalMatrices[last];
+      this->dirty[index] = this->dirty[last];
+    }
+
+    this->translationX.pop_back(); this->translationY.pop_back(); this->translationZ.pop_back();
+    this->rotationX.pop_back(); this->rotationY.pop_back(); this->rotationZ.pop_back();
+    this->scaleX.pop_back(); this->scaleY.pop_back(); this->scaleZ.pop_back();
+
+    this->parents.pop_back();
+
+    this->localMatrices.pop_back();
+    this->localNormalMatrices.pop_back();
+    this->dirty.pop_back();
+
+    this->isHierarchyChanged = true;
+  }
+
+  void EngineTransformPool::setTranslation(uint32_t index, glm::vec3 translation) {
+    this->translationX[index] = translation.x;
+    this->translationY[index] = translation.y;
+    this->translationZ[index] = translation.z;
+    this->markDirty(index);
+  }
+
+  void EngineTransformPool::setRotation(uint32_t index, glm::vec3 rotation) {
+    this->rotationX[index] = rotation.x;
+    this->rotationY[index] = rotation.y;
+    this->rotationZ[index] = rotation.z;
+    this->markDirty(index);
+  }
+
+  void EngineTransformPool::setScale(uint32_t index, glm::vec3 scale) {
+    this->scaleX[index] = scale.x;
+    this->scaleY[index] = scale.y;
+    this->scaleZ[index] = scale.z;
+    this->markDirty(index);
+  }
+
+  void EngineTransformPool::setParent(EngineEntity entity, EngineEntity parent) {
+    uint32_t index = this->indexOf(entity);
+    assert((!parent.isValid() || this->contains(parent)) && "parent does not have a transform");
+
+    // walk up from the new parent, reaching the entity itself would close a cycle
+    if (this->contains(parent)) {
+      for (uint32_t ancestor = this->indexOf(parent); ancestor != NO_PARENT; ancestor = this->getParentIndex(ancestor)) {
+        assert(ancestor != index && "a transform cannot be parented to its own descendant");
+      }
+    }
+
+    this->parents[index] = parent;
+    this->isHierarchyChanged = true;
+  }
+
+  uint32_t EngineTransformPool::getParentIndex(uint32_t index) const {
+    return this->contains(this->parents[index]) ? this->indexOf(this->parents[index]) : NO_PARENT;
+  }
+
+  void EngineTransformPool::markDirty(uint32_t index) {
+    if (this->dirty[index]) return;
+
+    this->dirty[index] = 1;
+    this->dirtyCount++;
+  }
+
+  EngineTransformStreams EngineTransformPool::getStreams() const {
+    return EngineTransformStreams{
+      this->translationX.data(), this->translationY.data(), this->translationZ.data(),
+      this->rotationX.data(), this->rotationY.data(), this->rotationZ.data(),
+      this->scaleX.data(), this->scaleY.data(), this->scaleZ.data()
+    };
+  }
+
+  void EngineTransformPool::updateMatrices(EngineThreadPool &threadPool) {
+    this->changedIndices.clear();
+
+    bool isHierarchyRebuilt = this->isHierarchyChanged;
+    if (isHierarchyRebuilt) {
+      this->rebuildHierarchy();
+    }
+
+    if (this->dirtyCount == 0 && !isHierarchyRebuilt) return;
+
+    this->updateLocalMatrices(threadPool);
+    this->updateWorldMatrices(threadPool, isHierarchyRebuilt);
+
+    std::fill(this->dirty.begin(), this->dirty.end(), 0);
+    this->dirtyCount = 0;
+  }
+
+  void EngineTransformPool::updateLocalMatrices(EngineThreadPool &threadPool) {
+    if (this->dirtyCount == 0) return;
+
+    const EngineTransformStreams streams = this->getStreams();
+    const uint32_t count = this->size();
+
+    // batches are multiples of four so every kernel block stays inside one batch
+    threadPool.parallelFor(count, 256, [this, &streams](uint32_t begin, uint32_t end, uint32_t threadIndex) {
+      for (uint32_t block = begin; block < end; block += 4) {
+        uint32_t blockEnd = std::min(block + 4, end);
+
+        bool isBlockDirty = false;
+        for (uint32_t i = block; i < blockEnd; i++) {
+          isBlockDirty |= this->dirty[i] != 0;
+        }
+
+        if (!isBlockDirty) continue;
+
+        // rebuilding a clean neighbour in the same block is cheaper than splitting the block
+        EngineTransformStreams blockStreams = streams;
+        for (const float** stream : { &blockStreams.translationX, &blockStreams.translationY, &blockStreams.translationZ, 
+          &blockStreams.rotationX, &blockStreams.rotationY, &blockStreams.rotationZ, &blockStreams.scaleX, &blockStreams.scaleY, &blockStreams.scaleZ }) 
+        {
+          *stream += block;
+        }
+
+        computeTransformMatrices(blockStreams, blockEnd - block, this->localMatrices.data() + block, this->localNormalMatrices.data() + block);
+      }
+    });
+  }
+
+  // a node changes when its own transform did or its parent's world matrix did; parents sit in the
+  // previous level, so every level only reads what the last sweep finished
+  void EngineTransformPool::updateWorldMatrices(EngineThreadPool &threadPool, bool isForced) {
+    // every worker collects what it changed on its own, merged once all levels are done
+    this->threadChangedIndices.resize(threadPool.getThreadCount());
+
+    for (uint32_t level = 0; level + 1 < this->levelOffsets.size(); level++) {
+      uint32_t levelBegin = this->levelOffsets[level];
+      uint32_t levelCount = this->levelOffsets[level + 1] - levelBegin;
+
+      threadPool.parallelFor(levelCount, 256, [this, levelBegin, isForced](uint32_t begin, uint32_t end, uint32_t threadIndex) {
+        for (uint32_t slot = levelBegin + begin; slot < levelBegin + end; slot++) {
+          uint32_t index = this->slotIndices[slot];
+          uint32_t parentSlot = this->parentSlots[slot];
+
+          bool isChanged = isForced || this->dirty[index] != 0 || (parentSlot != NO_PARENT && this->worldChanged[parentSlot] != 0);
+          this->worldChanged[slot] = isChanged ? 1 : 0;
+
+          if (!isChanged) continue;
+
+          this->threadChangedIndices[threadIndex].push_back(index);
+
+          if (parentSlot == NO_PARENT) {
+            this->worldMatrices[slot] = this->localMatrices[index];
+            this->worldNormalMatrices[slot] = this->localNormalMatrices[index];
+          } else {
+            // the inverse transpose of a product is the product of the inverse transposes
+            this->worldMatrices[slot] = this->worldMatrices[parentSlot] * this->localMatrices[index];
+            this->worldNormalMatrices[slot] = this->worldNormalMatrices[parentSlot] * this->localNormalMatrices[index];
+          }
+        }
+      });
+    }
+
+    for (auto &indices : this->threadChangedIndices) {
+      this->changedIndices.insert(this->changedIndices.end(), indices.begin(), indices.end());
+      indices.clear();
+    }
+  }
+
+  // counting sort of the transforms by depth; only runs after an add, remove or reparent
+  void EngineTransformPool::rebuildHierarchy() {
+    const uint32_t count = this->size();
+    const uint32_t unresolved = std::numeric_limits<uint32_t>::max();
+
+    std::vector<uint32_t> depths(count, unresolved);
+    std::vector<uint32_t> chain;
+    uint32_t maxDepth = 0;
+
+    for (uint32_t i = 0; i < count; i++) {
+      // climb until a node with a known depth or a root, then number the chain back down
+      uint32_t node = i;
+      chain.clear();
+
+      while (depths[node] == unresolved) {
+        chain.push_back(node);
+
+        uint32_t parent = this->getParentIndex(node);
+        if (parent == NO_PARENT) break;
+
+        node = parent;
+      }
+
+      uint32_t depth = depths[node] == unresolved ? 0 : depths[node] + 1;
+      for (auto it = chain.rbegin(); it != chain.rend(); it++) {
+        depths[*it] = depth++;
+      }
+
+      maxDepth = std::max(maxDepth, depths[i]);
+    }
+
+    this->levelOffsets.assign(count > 0 ? maxDepth + 2 : 1, 0);
+    for (uint32_t i = 0; i < count; i++) {
+      this->levelOffsets[depths[i] + 1]++;
+    }
+
+    for (uint32_t level = 1; level < this->levelOffsets.size(); level++) {
+      this->levelOffsets[level] += this->levelOffsets[level - 1];
+    }
+
+    this->slots.resize(count);
+    this->slotIndices.resize(count);
+    this->parentSlots.resize(count);
+
+    std::vector<uint32_t> nextSlots(this->levelOffsets.begin(), this->levelOffsets.end() - 1);
+    for (uint32_t i = 0; i < count; i++) {
+      uint32_t slot = nextSlots[depths[i]]++;
+
+      this->slots[i] = slot;
+      this->slotIndices[slot] = i;
+    }
+
+    for (uint32_t slot = 0; slot < count; slot++) {
+      uint32_t parent = this->getParentIndex(this->slotIndices[slot]);
+      this->parentSlots[slot] = parent == NO_PARENT ? NO_PARENT : this->slots[parent];
+    }
+
+    this->worldMatrices.resize(count);
+    this->worldNormalMatrices.resize(count);
+    this->worldChanged.resize(count);
+
+    this->isHierarchyChanged = false;
+  }
+  
+} // namespace nugiEngine
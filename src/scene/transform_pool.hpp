@@ -0,0 +1,89 @@
+#pragma once
+
+#include "component_pool.hpp"
+#include "../thread/thread_pool.hpp"
+#include "../game_object/transform_batch.hpp"
+
+#define GLM_FORCE_RADIANS
+#define GLM_FORCE_DEPTH_ZERO_TO_ONE
+#include <glm/glm.hpp>
+
+// std lib headers
+#include <limits>
+#include <vector>
+
+namespace nugiEngine {
+  /**
+   * Transforms of every entity that has one, one array per component so the batch kernel can
+   * stream them. Setters mark the entity dirty; updateMatrices() only rebuilds dirty matrices,
+   * so a static scene costs nothing here.
+   *
+   * A transform may have a parent, its translation, rotation & scale are then relative to it.
+   * World matrices are kept sorted by depth, so every parent comes before its children and the
+   * propagation is one linear sweep per level, each level spread over the thread pool.
+   */
+  class EngineTransformPool : public EngineSparseSet {
+    public:
+      void add(EngineEntity entity, glm::vec3 translation, glm::vec3 rotation = glm::vec3{0.0f}, glm::vec3 scale = glm::vec3{1.0f});
+      void remove(EngineEntity entity);
+
+      glm::vec3 getTranslation(uint32_t index) const { return glm::vec3{this->translationX[index], this->translationY[index], this->translationZ[index]}; }
+      glm::vec3 getRotation(uint32_t index) const { return glm::vec3{this->rotationX[index], this->rotationY[index], this->rotationZ[index]}; }
+      glm::vec3 getScale(uint32_t index) const { return glm::vec3{this->scaleX[index], this->scaleY[index], this->scaleZ[index]}; }
+
+      void setTranslation(uint32_t index, glm::vec3 translation);
+      void setRotation(uint32_t index, glm::vec3 rotation);
+      void setScale(uint32_t index, glm::vec3 scale);
+
+      // an invalid parent detaches; when the parent loses its transform, its children become roots
+      void setParent(EngineEntity entity, EngineEntity parent);
+      EngineEntity getParent(uint32_t index) const { return this->parents[index]; }
+
+      // world space, valid after the last updateMatrices() that followed a change
+      const glm::mat4& getModelMatrix(uint32_t index) const { return this->worldMatrices[this->slots[index]]; }
+      const glm::mat4& getNormalMatrix(uint32_t index) const { return this->worldNormalMatrices[this->slots[index]]; }
+
+      void updateMatrices(EngineThreadPool &threadPool);
+
+      // dense indices whose world matrix the last updateMatrices() changed, in no particular order
+      const std::vector<uint32_t>& getChangedIndices() const { return this->changedIndices; }
+
+    private:
+      static constexpr uint32_t NO_PARENT = std::numeric_limits<uint32_t>::max();
+
+      void markDirty(uint32_t index);
+      uint32_t getParentIndex(uint32_t index) const;
+      EngineTransformStreams getStreams() const;
+
+      void updateLocalMatrices(EngineThreadPool &threadPool);
+      void updateWorldMatrices(EngineThreadPool &threadPool, bool isForced);
+      void rebuildHierarchy();
+
+      std::vector<float> translationX, translationY, translationZ;
+      std::vector<float> rotationX, rotationY, rotationZ;
+      std::vector<float> scaleX, scaleY, scaleZ;
+      std::vector<EngineEntity> parents;
+
+      std::vector<glm::mat4> localMatrices;
+      std::vector<glm::mat4> localNormalMatrices;
+
+      std::vector<uint8_t> dirty;
+      uint32_t dirtyCount = 0;
+
+      // depth sorted: slot of every dense index, and per slot its dense index & its parent's slot
+      std::vector<uint32_t> slots;
+      std::vector<uint32_t> slotIndices;
+      std::vector<uint32_t> parentSlots;
+      std::vector<uint32_t> levelOffsets;
+
+      std::vector<glm::mat4> worldMatrices;
+      std::vector<glm::mat4> worldNormalMatrices;
+      std::vector<uint8_t> worldChanged;
+
+      std::vector<uint32_t> changedIndices;
+      std::vector<std::vector<uint32_t>> threadChangedIndices;
+
+      bool isHierarchyChanged = false;
+  };
+  
+} // namespace nugiEngine
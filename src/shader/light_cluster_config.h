@@ -0,0 +1,20 @@
+// Clustered lighting constants, shared by globalUbo.hpp and the shaders through
+// GL_GOOGLE_include_directive. Plain integer literals, so C++ and GLSL read them alike.
+#ifndef LIGHT_CLUSTER_CONFIG_H
+#define LIGHT_CLUSTER_CONFIG_H
+
+// view space cluster grid: screen tiles times exponential depth slices
+#define CLUSTER_GRID_X 16
+#define CLUSTER_GRID_Y 9
+#define CLUSTER_GRID_Z 24
+#define CLUSTER_COUNT (CLUSTER_GRID_X * CLUSTER_GRID_Y * CLUSTER_GRID_Z)
+
+// a cluster keeps at most this many lights, the ones past it are dropped in light index order
+// and counted in LightClusterOverflow
+#define MAX_LIGHTS_PER_CLUSTER 64
+
+// the light storage buffer is bound with a fixed range that holds this many lights,
+// the scene lights past it are not uploaded
+#define MAX_LIGHTS 4096
+
+#endif
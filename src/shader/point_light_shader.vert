@@ -9,12 +9,11 @@ const vec2 OFFSETS[6] = vec2[](
   vec2(1.0, 1.0)
 );
 
-layout (location = 0) out vec2 fragOffset;
+layout (location = 0) in vec4 instancePosition; // w: radius
+layout (location = 1) in vec4 instanceColor;
 
-struct PointLight {
-  vec4 position;
-  vec4 color;
-};
+layout (location = 0) out vec2 fragOffset;
+layout (location = 1) out vec4 fragColor;
 
 layout(set = 0, binding = 0) uniform GlobalUbo {
     mat4 projection;
@@ -22,26 +21,17 @@ layout(set = 0, binding = 0) uniform GlobalUbo {
     mat4 inverseView;
 } ubo;
 
-layout(set = 0, binding = 1) uniform GlobalLight {
-    vec4 ambientLightColor;
-    PointLight pointLights[10];
-    int numLights;
-} globalLight;
-
-layout(push_constant) uniform Push {
-  vec4 position;
-  vec4 color;
-  float radius;
-} push;
-
 void main() {
   fragOffset = OFFSETS[gl_VertexIndex];
   vec3 cameraRightWorld = {ubo.view[0][0], ubo.view[1][0], ubo.view[2][0]};
   vec3 cameraUpWorld = {ubo.view[0][1], ubo.view[1][1], ubo.view[2][1]};
 
-  vec3 positionWorld = push.position.xyz
-    + push.radius * fragOffset.x * cameraRightWorld
-    + push.radius * fragOffset.y * cameraUpWorld;
+  // six vertices per billboard, the instance attributes select the light
+  vec3 positionWorld = instancePosition.xyz
+    + instancePosition.w * fragOffset.x * cameraRightWorld
+    + instancePosition.w * fragOffset.y * cameraUpWorld;
+
+  fragColor = instanceColor;
 
   gl_Position = ubo.projection * ubo.view * vec4(positionWorld, 1.0);
 }
\ No newline at end of file
@@ -1,4 +1,5 @@
 #version 450
+#extension GL_GOOGLE_include_directive : require
 
 layout(location = 0) in vec3 fragColor;
 layout(location = 1) in vec3 fragPosWorld;
@@ -6,8 +7,10 @@ layout(location = 2) in vec3 fragNormalWorld;
 
 layout(location = 0) out vec4 outColor;
 
+#include "light_cluster_config.h"
+
 struct PointLight {
-  vec4 position;
+  vec4 position; // w: range
   vec4 color;
 };
 
@@ -17,16 +20,28 @@ layout(set = 0, binding = 0) uniform GlobalUbo {
     mat4 inverseView;
 } ubo;
 
-layout(set = 0, binding = 1) uniform GlobalLight {
+layout(std430, set = 0, binding = 1) readonly buffer GlobalLight {
     vec4 ambientLightColor;
-    PointLight pointLights[10];
-    int numLights;
+    vec4 clusterParams; // tile size in pixels, depth slice scale & bias
+    uint numLights;
+    PointLight pointLights[];
 } globalLight;
 
-layout(push_constant) uniform Push {
-    mat4 modelMatrix;
-    mat4 normalMatrix;
-} push;
+layout(std430, set = 0, binding = 2) readonly buffer LightClusters {
+    uint lightCounts[CLUSTER_COUNT];
+    uint lightIndices[];
+} lightClusters;
+
+uint findCluster(vec3 positionWorld) {
+    float viewDepth = (ubo.view * vec4(positionWorld, 1.0)).z;
+    uint slice = uint(max(log(viewDepth) * globalLight.clusterParams.z + globalLight.clusterParams.w, 0.0));
+    uvec2 tile = uvec2(gl_FragCoord.xy / globalLight.clusterParams.xy);
+
+    tile = min(tile, uvec2(CLUSTER_GRID_X - 1u, CLUSTER_GRID_Y - 1u));
+    slice = min(slice, CLUSTER_GRID_Z - 1u);
+
+    return tile.x + tile.y * CLUSTER_GRID_X + slice * CLUSTER_GRID_X * CLUSTER_GRID_Y;
+}
 
 void main() {
     vec3 diffuseLight = globalLight.ambientLightColor.xyz * globalLight.ambientLightColor.w;
@@ -36,11 +51,19 @@ void main() {
     vec3 cameraPosWorld = ubo.inverseView[3].xyz;
     vec3 viewDirection = normalize(cameraPosWorld - fragPosWorld);
 
-    for (int i = 0; i < globalLight.numLights; i++) {
-        PointLight light = globalLight.pointLights[i];
+    // only the lights binned into this fragment's cluster can reach it
+    uint cluster = findCluster(fragPosWorld);
+    uint lightCount = lightClusters.lightCounts[cluster];
+
+    for (uint i = 0; i < lightCount; i++) {
+        PointLight light = globalLight.pointLights[lightClusters.lightIndices[cluster * MAX_LIGHTS_PER_CLUSTER + i]];
 
         vec3 directionToLight = light.position.xyz - fragPosWorld;
-        float attenuation = 1.0 / dot(directionToLight, directionToLight);
+        float distanceSquared = dot(directionToLight, directionToLight);
+
+        // fades to zero at the range, so nothing pops at the cluster borders
+        float rangeFactor = clamp(1.0 - distanceSquared / (light.position.w * light.position.w), 0.0, 1.0);
+        float attenuation = rangeFactor * rangeFactor / distanceSquared;
         directionToLight = normalize(directionToLight);
         
         float cosAngIncidence = max(dot(surfaceNormal, directionToLight), 0);
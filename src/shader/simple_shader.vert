@@ -4,38 +4,24 @@ layout(location = 0) in vec3 position;
 layout(location = 1) in vec3 inColor;
 layout(location = 2) in vec3 normal;
 layout(location = 3) in vec2 uv;
+layout(location = 4) in mat4 modelMatrix;
+layout(location = 8) in mat4 normalMatrix;
 
 layout(location = 0) out vec3 fragColor;
 layout(location = 1) out vec3 fragPosWorld;
 layout(location = 2) out vec3 fragNormalWorld;
 
-struct PointLight {
-  vec4 position;
-  vec4 color;
-};
-
 layout(set = 0, binding = 0) uniform GlobalUbo {
     mat4 projection;
     mat4 view;
     mat4 inverseView;
 } ubo;
 
-layout(set = 0, binding = 1) uniform GlobalLight {
-    vec4 ambientLightColor;
-    PointLight pointLights[10];
-    int numLights;
-} globalLight;
-
-layout(push_constant) uniform Push {
-    mat4 modelMatrix;
-    mat4 normalMatrix;
-} push;
-
 void main() {
-    vec4 positionWorld = push.modelMatrix * vec4(position, 1.0);
+    vec4 positionWorld = modelMatrix * vec4(position, 1.0);
     gl_Position = ubo.projection * ubo.view * positionWorld;
 
-    fragNormalWorld = normalize(mat3(push.normalMatrix) * normal);
+    fragNormalWorld = normalize(mat3(normalMatrix) * normal);
     fragPosWorld = positionWorld.xyz;
     fragColor = inColor;
 }
\ No newline at end of file
@@ -30,31 +30,12 @@ namespace nugiEngine {
 
     this->mipLevels = static_cast<uint32_t>(std::floor(std::log2(std::max(texWidth, texHeight)))) + 1;
 
-    unsigned long pixelSize = 4;
-    uint32_t pixelCount = texWidth * texHeight;
-
-    EngineBuffer stagingBuffer {
-			this->appDevice,
-			pixelSize,
-			pixelCount,
-			VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-			VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT
-		};
-
-    stagingBuffer.map();
-    stagingBuffer.writeToBuffer(pixels);
-    stagingBuffer.unmap();
-
-    stbi_image_free(pixels);
-
     this->image = std::make_unique<EngineImage>(this->appDevice, texWidth, texHeight, this->mipLevels, VK_SAMPLE_COUNT_1_BIT, VK_FORMAT_R8G8B8A8_SRGB, 
       VK_IMAGE_TILING_OPTIMAL, VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT, 
       VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, VK_IMAGE_ASPECT_COLOR_BIT);
 
-    this->image->transitionImageLayout(VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
-    stagingBuffer.copyBufferToImage(this->image->getImage(), static_cast<uint32_t>(texWidth), static_cast<uint32_t>(texHeight), 1);
-    this->image->generateMipMap();
-    // this->image->transitionImageLayout(VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+    this->uploadHandle = this->appDevice.getUploadService()->uploadImage(*this->image, pixels, imageSize);
+    stbi_image_free(pixels);
   }
 
   void EngineTexture::createTextureSampler() {
@@ -86,6 +67,10 @@ namespace nugiEngine {
     }
   }
 
+  bool EngineTexture::isReady() {
+    return this->appDevice.getUploadService()->isComplete(this->uploadHandle);
+  }
+
   VkDescriptorImageInfo EngineTexture::getDescriptorInfo() {
     VkDescriptorImageInfo imageInfo{};
     imageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
@@ -7,6 +7,7 @@
 #include "../buffer/buffer.hpp"
 #include "../command/command_buffer.hpp"
 #include "../image/image.hpp"
+#include "../upload/upload_service.hpp"
 
 #include <memory>
 
@@ -20,12 +21,16 @@ namespace nugiEngine
 
       VkDescriptorImageInfo getDescriptorInfo();
 
+      // false until the pixels and mip chain are on the GPU
+      bool isReady();
+
     private:
       EngineDevice &appDevice;
       std::unique_ptr<EngineImage> image;
 
       VkSampler sampler;
       uint32_t mipLevels;
+      EngineUploadHandle uploadHandle;
 
       void createTextureImage(const char* textureFileName);
       void createTextureSampler();
@@ -0,0 +1,77 @@
+#include "task_graph.hpp"
+
+#include <cassert>
+
+namespace nugiEngine {
+  EngineTaskId EngineTaskGraph::addTask(std::function<void(uint32_t threadIndex)> task, std::vector<EngineTaskId> dependencies) {
+    EngineTaskId taskId = static_cast<EngineTaskId>(this->nodes.size());
+
+    auto node = std::make_unique<TaskNode>();
+    node->task = std::move(task);
+    node->dependencyCount = static_cast<uint32_t>(dependencies.size());
+
+    for (auto dependency : dependencies) {
+      assert(dependency < taskId && "a task can only depend on tasks added before it");
+      this->nodes[dependency]->successors.push_back(taskId);
+    }
+
+    this->nodes.emplace_back(std::move(node));
+    return taskId;
+  }
+
+  void EngineTaskGraph::run(EngineThreadPool &threadPool) {
+    if (this->nodes.empty()) return;
+
+    for (auto &node : this->nodes) {
+      node->remainingDependencies.store(node->dependencyCount);
+    }
+
+    this->remainingTasks.store(static_cast<uint32_t>(this->nodes.size()));
+    this->error = nullptr;
+    this->failed.store(false);
+
+    for (EngineTaskId taskId = 0; taskId < this->nodes.size(); taskId++) {
+      if (this->nodes[taskId]->dependencyCount == 0) {
+        this->submitTask(threadPool, taskId);
+      }
+    }
+
+    threadPool.waitFor(this->remainingTasks);
+
+    if (this->error) {
+      std::rethrow_exception(this->error);
+    }
+  }
+
+  void EngineTaskGraph::clear() {
+    this->nodes.clear();
+  }
+
+  void EngineTaskGraph::submitTask(EngineThreadPool &threadPool, EngineTaskId taskId) {
+    threadPool.submit([this, &threadPool, taskId](uint32_t threadIndex) {
+      auto &node = *this->nodes[taskId];
+
+      // an exception must not unwind a worker; the first one is kept for run() and the tasks
+      // that have not started yet are skipped, but still counted so the graph drains
+      if (!this->failed.load()) {
+        try {
+          node.task(threadIndex);
+        } catch (...) {
+          std::lock_guard<std::mutex> lock{this->errorMutex};
+          if (!this->error) this->error = std::current_exception();
+          this->failed.store(true);
+        }
+      }
+
+      for (auto successor : node.successors) {
+        if (this->nodes[successor]->remainingDependencies.fetch_sub(1) == 1) {
+          this->submitTask(threadPool, successor);
+        }
+      }
+
+      if (this->remainingTasks.fetch_sub(1) == 1) {
+        threadPool.notifyWaiters();
+      }
+    });
+  }
+} // namespace nugiEngine
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "thread_pool.hpp"
+
+// std lib headers
+#include <atomic>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace nugiEngine {
+  typedef uint32_t EngineTaskId;
+
+  // Tasks with dependencies between them, run on the thread pool. A task is queued as soon as
+  // the last of its dependencies has finished, on the worker that finished it
+  class EngineTaskGraph {
+    public:
+      EngineTaskGraph() = default;
+
+      EngineTaskGraph(const EngineTaskGraph &) = delete;
+      EngineTaskGraph &operator=(const EngineTaskGraph &) = delete;
+
+      // dependencies must have been added before
+      EngineTaskId addTask(std::function<void(uint32_t threadIndex)> task, std::vector<EngineTaskId> dependencies = {});
+
+      // runs every task once and returns when all of them have finished; the first exception
+      // a task throws is rethrown here, the tasks that had not started by then are skipped
+      void run(EngineThreadPool &threadPool);
+      void clear();
+
+    private:
+      struct TaskNode {
+        std::function<void(uint32_t)> task;
+        std::vector<EngineTaskId> successors;
+        uint32_t dependencyCount = 0;
+        std::atomic<uint32_t> remainingDependencies{0};
+      };
+
+      void submitTask(EngineThreadPool &threadPool, EngineTaskId taskId);
+
+      std::vector<std::unique_ptr<TaskNode>> nodes;
+      std::atomic<uint32_t> remainingTasks{0};
+
+      std::exception_ptr error;
+      std::mutex errorMutex;
+      std::atomic<bool> failed{false};
+  };
+} // namespace nugiEngine
@@ -0,0 +1,169 @@
+#include "thread_pool.hpp"
+
+#include <cassert>
+
+namespace nugiEngine {
+  // which pool the current thread works for, and as which worker
+  static thread_local const EngineThreadPool* currentPool = nullptr;
+  static thread_local int32_t currentWorkerIndex = -1;
+
+  EngineThreadPool::EngineThreadPool(uint32_t threadCount) {
+    for (uint32_t i = 0; i < threadCount; i++) {
+      this->queues.emplace_back(std::make_unique<WorkerQueue>());
+    }
+
+    for (uint32_t i = 0; i < threadCount; i++) {
+      this->workers.emplace_back(&EngineThreadPool::workerLoop, this, i);
+    }
+  }
+
+  EngineThreadPool::~EngineThreadPool() {
+    {
+      std::lock_guard<std::mutex> lock{this->sleepMutex};
+      this->isStopping = true;
+    }
+
+    this->taskAvailable.notify_all();
+
+    for (auto &worker : this->workers) {
+      worker.join();
+    }
+  }
+
+  int32_t EngineThreadPool::getCurrentWorkerIndex() const {
+    return currentPool == this ? currentWorkerIndex : -1;
+  }
+
+  void EngineThreadPool::submit(std::function<void(uint32_t threadIndex)> task) {
+    int32_t workerIndex = this->getCurrentWorkerIndex();
+    uint32_t queueIndex = workerIndex >= 0 ? static_cast<uint32_t>(workerIndex) : this->nextQueue.fetch_add(1) % this->getThreadCount();
+
+    this->pendingCount.fetch_add(1);
+
+    {
+      std::lock_guard<std::mutex> lock{this->queues[queueIndex]->mutex};
+      this->queues[queueIndex]->tasks.push_back(std::move(task));
+    }
+
+    this->queuedCount.fetch_add(1);
+
+    // taking the lock orders this with a worker that just found nothing and is about to sleep
+    {
+      std::lock_guard<std::mutex> lock{this->sleepMutex};
+    }
+
+    this->taskAvailable.notify_one();
+  }
+
+  void EngineThreadPool::wait() {
+    assert(this->getCurrentWorkerIndex() < 0 && "wait() would wait on the calling task itself, use waitFor()");
+    this->waitFor(this->pendingCount);
+  }
+
+  void EngineThreadPool::waitFor(const std::atomic<uint32_t> &counter) {
+    int32_t workerIndex = this->getCurrentWorkerIndex();
+
+    if (workerIndex >= 0) {
+      while (counter.load() > 0) {
+        if (!this->tryRunTask(static_cast<uint32_t>(workerIndex))) {
+          std::this_thread::yield();
+        }
+      }
+
+      return;
+    }
+
+    std::unique_lock<std::mutex> lock{this->sleepMutex};
+    this->tasksDone.wait(lock, [&counter] { return counter.load() == 0; });
+  }
+
+  void EngineThreadPool::notifyWaiters() {
+    {
+      std::lock_guard<std::mutex> lock{this->sleepMutex};
+    }
+
+    this->tasksDone.notify_all();
+  }
+
+  void EngineThreadPool::parallelFor(uint32_t count, uint32_t batchSize, std::function<void(uint32_t begin, uint32_t end, uint32_t threadIndex)> task) {
+    if (count == 0) return;
+
+    batchSize = std::max(batchSize, 1u);
+    std::atomic<uint32_t> remainingBatches{(count + batchSize - 1) / batchSize};
+
+    // an exception must not unwind a worker, it is kept for the caller instead
+    std::exception_ptr error;
+    std::mutex errorMutex;
+
+    for (uint32_t begin = 0; begin < count; begin += batchSize) {
+      uint32_t end = std::min(begin + batchSize, count);
+
+      this->submit([this, begin, end, &task, &remainingBatches, &error, &errorMutex](uint32_t threadIndex) {
+        try {
+          task(begin, end, threadIndex);
+        } catch (...) {
+          std::lock_guard<std::mutex> lock{errorMutex};
+          if (!error) error = std::current_exception();
+        }
+
+        if (remainingBatches.fetch_sub(1) == 1) {
+          this->notifyWaiters();
+        }
+      });
+    }
+
+    this->waitFor(remainingBatches);
+
+    if (error) {
+      std::rethrow_exception(error);
+    }
+  }
+
+  bool EngineThreadPool::tryRunTask(uint32_t threadIndex) {
+    std::function<void(uint32_t)> task;
+    uint32_t queueCount = this->getThreadCount();
+
+    // own deque from the back (most recent, still in cache), others from the front
+    for (uint32_t i = 0; i < queueCount && !task; i++) {
+      auto &queue = *this->queues[(threadIndex + i) % queueCount];
+      std::lock_guard<std::mutex> lock{queue.mutex};
+
+      if (queue.tasks.empty()) continue;
+
+      if (i == 0) {
+        task = std::move(queue.tasks.back());
+        queue.tasks.pop_back();
+      } else {
+        task = std::move(queue.tasks.front());
+        queue.tasks.pop_front();
+      }
+    }
+
+    if (!task) return false;
+
+    this->queuedCount.fetch_sub(1);
+    task(threadIndex);
+
+    if (this->pendingCount.fetch_sub(1) == 1) {
+      this->notifyWaiters();
+    }
+
+    return true;
+  }
+
+  void EngineThreadPool::workerLoop(uint32_t threadIndex) {
+    currentPool = this;
+    currentWorkerIndex = static_cast<int32_t>(threadIndex);
+
+    while (true) {
+      if (this->tryRunTask(threadIndex)) continue;
+
+      std::unique_lock<std::mutex> lock{this->sleepMutex};
+      this->taskAvailable.wait(lock, [this] { return this->isStopping || this->queuedCount.load() > 0; });
+
+      if (this->isStopping && this->queuedCount.load() <= 0) {
+        return;
+      }
+    }
+  }
+} // namespace nugiEngine
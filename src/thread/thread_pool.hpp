@@ -0,0 +1,71 @@
+#pragma once
+
+// std lib headers
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace nugiEngine {
+  // Fixed set of worker threads with one task deque each. A worker pops the newest task of its own
+  // deque and steals the oldest one of another worker's when it runs dry. Every task gets the index
+  // of the worker running it, so it can use per-thread resources without locking
+  class EngineThreadPool {
+    public:
+      EngineThreadPool(uint32_t threadCount = std::max(std::thread::hardware_concurrency(), 2u) - 1);
+      ~EngineThreadPool();
+
+      EngineThreadPool(const EngineThreadPool &) = delete;
+      EngineThreadPool &operator=(const EngineThreadPool &) = delete;
+
+      // the queues are all created before the first worker starts, the workers vector is not
+      uint32_t getThreadCount() const { return static_cast<uint32_t>(this->queues.size()); }
+
+      // tasks submitted from a worker go to its own deque, others are spread round robin
+      void submit(std::function<void(uint32_t threadIndex)> task);
+
+      // blocks until every submitted task has finished; not callable from a task
+      void wait();
+
+      // blocks until counter drops to zero; a worker keeps running tasks meanwhile instead of sleeping
+      void waitFor(const std::atomic<uint32_t> &counter);
+
+      // wakes the waitFor callers, call after bringing a counter they wait on down to zero
+      void notifyWaiters();
+
+      // splits [0, count) into batches of at most batchSize and returns once all have run; the first
+      // exception a batch throws is rethrown here, after the other batches have finished
+      void parallelFor(uint32_t count, uint32_t batchSize, std::function<void(uint32_t begin, uint32_t end, uint32_t threadIndex)> task);
+
+    private:
+      struct WorkerQueue {
+        std::mutex mutex;
+        std::deque<std::function<void(uint32_t)>> tasks;
+      };
+
+      void workerLoop(uint32_t threadIndex);
+      bool tryRunTask(uint32_t threadIndex);
+      int32_t getCurrentWorkerIndex() const;
+
+      std::vector<std::thread> workers;
+      std::vector<std::unique_ptr<WorkerQueue>> queues;
+
+      std::atomic<int32_t> queuedCount{0};
+      std::atomic<uint32_t> pendingCount{0}; // queued + running
+      std::atomic<uint32_t> nextQueue{0};
+
+      // only guards sleeping & waking, the deques have their own locks
+      std::mutex sleepMutex;
+      std::condition_variable taskAvailable;
+      std::condition_variable tasksDone;
+
+      bool isStopping = false;
+  };
+} // namespace nugiEngine
@@ -0,0 +1,95 @@
+#include "staging_ring.hpp"
+
+// std headers
+#include <algorithm>
+#include <cassert>
+
+namespace nugiEngine {
+  EngineStagingRing::EngineStagingRing(EngineDevice &device, VkDeviceSize capacity) : capacity{capacity} {
+    // 16 bytes keeps every texel format and the copy engine's preferred offset happy
+    this->alignment = std::max<VkDeviceSize>(device.getProperties().limits.optimalBufferCopyOffsetAlignment, 16);
+
+    this->buffer = std::make_unique<EngineBuffer>(
+      device,
+      capacity,
+      1,
+      VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+      VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT
+    );
+
+    this->buffer->map();
+  }
+
+  bool EngineStagingRing::allocate(VkDeviceSize minSize, VkDeviceSize maxSize, VkDeviceSize granularity, uint64_t batchId,
+    VkDeviceSize &offset, VkDeviceSize &size)
+  {
+    assert(minSize > 0 && minSize <= maxSize && "Invalid staging request");
+    assert(minSize % granularity == 0 && "Minimum staging size must be a multiple of the granularity");
+
+    if (this->usedSize == 0) {
+      this->head = 0;
+      this->tail = 0;
+    }
+
+    VkDeviceSize alignedHead = (this->head + this->alignment - 1) / this->alignment * this->alignment;
+    VkDeviceSize start, available, skipped;
+
+    if (this->usedSize == 0 || this->head > this->tail) {
+      // free space is [head, capacity) followed by [0, tail)
+      VkDeviceSize endSpace = (this->capacity > alignedHead) ? this->capacity - alignedHead : 0;
+
+      if (endSpace >= minSize) {
+        start = alignedHead;
+        available = endSpace;
+        skipped = alignedHead - this->head;
+      } else if (this->tail >= minSize) {
+        start = 0;
+        available = this->tail;
+        skipped = this->capacity - this->head;
+      } else {
+        return false;
+      }
+    } else if (this->head < this->tail) {
+      VkDeviceSize space = (this->tail > alignedHead) ? this->tail - alignedHead : 0;
+      if (space < minSize) {
+        return false;
+      }
+
+      start = alignedHead;
+      available = space;
+      skipped = alignedHead - this->head;
+    } else {
+      // head caught up with tail: everything is in flight
+      return false;
+    }
+
+    offset = start;
+    size = std::min(available, maxSize) / granularity * granularity;
+
+    this->head = start + size;
+    this->usedSize += skipped + size;
+
+    if (!this->regions.empty() && this->regions.back().batchId == batchId) {
+      this->regions.back().end = this->head;
+      this->regions.back().size += skipped + size;
+    } else {
+      this->regions.push_back(Region{ batchId, this->head, skipped + size });
+    }
+
+    return true;
+  }
+
+  void EngineStagingRing::release(uint64_t completedBatchId) {
+    while (!this->regions.empty() && this->regions.front().batchId <= completedBatchId) {
+      this->tail = this->regions.front().end;
+      this->usedSize -= this->regions.front().size;
+      this->regions.pop_front();
+    }
+
+    if (this->usedSize == 0) {
+      this->head = 0;
+      this->tail = 0;
+    }
+  }
+
+} // namespace nugiEngine
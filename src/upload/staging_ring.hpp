@@ -0,0 +1,52 @@
+#pragma once
+
+#include "../device/device.hpp"
+#include "../buffer/buffer.hpp"
+
+// std lib headers
+#include <deque>
+#include <memory>
+
+namespace nugiEngine {
+  // Persistently mapped ring of host visible memory used as the source of every
+  // host to device copy. Space is tagged with the upload batch that consumed it
+  // and handed back once that batch's fence has signaled.
+  class EngineStagingRing {
+    public:
+      static constexpr VkDeviceSize defaultCapacity = 32ULL * 1024 * 1024;
+
+      EngineStagingRing(EngineDevice &device, VkDeviceSize capacity = defaultCapacity);
+
+      EngineStagingRing(const EngineStagingRing &) = delete;
+      EngineStagingRing &operator=(const EngineStagingRing &) = delete;
+
+      // Reserves between minSize and maxSize bytes (a multiple of granularity) of contiguous space.
+      // Returns false when not even minSize is free right now
+      bool allocate(VkDeviceSize minSize, VkDeviceSize maxSize, VkDeviceSize granularity, uint64_t batchId,
+        VkDeviceSize &offset, VkDeviceSize &size);
+      void release(uint64_t completedBatchId);
+
+      void* getMappedMemory(VkDeviceSize offset) const { return static_cast<char*>(this->buffer->getMappedMemory()) + offset; }
+      VkBuffer getBuffer() const { return this->buffer->getBuffer(); }
+      VkDeviceSize getCapacity() const { return this->capacity; }
+      VkDeviceSize getUsedSize() const { return this->usedSize; }
+
+    private:
+      struct Region {
+        uint64_t batchId;
+        VkDeviceSize end;
+        VkDeviceSize size;
+      };
+
+      std::unique_ptr<EngineBuffer> buffer;
+
+      VkDeviceSize capacity;
+      VkDeviceSize alignment;
+      VkDeviceSize head = 0;
+      VkDeviceSize tail = 0;
+      VkDeviceSize usedSize = 0;
+
+      std::deque<Region> regions;
+  };
+
+} // namespace nugiEngine
@@ -0,0 +1,445 @@
+#include "upload_service.hpp"
+
+// std headers
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <stdexcept>
+
+namespace nugiEngine {
+  EngineUploadService::EngineUploadService(EngineDevice &device) : appDevice{device} {
+    QueueFamilyIndices indices = this->appDevice.findPhysicalQueueFamilies();
+
+    this->graphicsFamily = indices.graphicsFamily;
+    this->transferFamily = indices.transferFamilyHasValue ? indices.transferFamily : indices.graphicsFamily;
+
+    this->graphicsCommandPool = this->createCommandPool(this->graphicsFamily);
+    if (this->hasDedicatedTransferQueue()) {
+      this->transferCommandPool = this->createCommandPool(this->transferFamily);
+    }
+
+    this->stagingRing = std::make_unique<EngineStagingRing>(this->appDevice);
+  }
+
+  EngineUploadService::~EngineUploadService() {
+    this->submitOpenBatch();
+
+    while (!this->submittedBatches.empty()) {
+      auto batch = std::move(this->submittedBatches.front());
+      this->submittedBatches.pop_front();
+
+      vkWaitForFences(this->appDevice.getLogicalDevice(), 1, &batch->fence, VK_TRUE, UINT64_MAX);
+      this->destroyBatch(std::move(batch));
+    }
+
+    if (this->transferCommandPool != VK_NULL_HANDLE) {
+      vkDestroyCommandPool(this->appDevice.getLogicalDevice(), this->transferCommandPool, nullptr);
+    }
+
+    vkDestroyCommandPool(this->appDevice.getLogicalDevice(), this->graphicsCommandPool, nullptr);
+  }
+
+  EngineUploadHandle EngineUploadService::uploadBuffer(EngineBuffer &dstBuffer, const void* data, VkDeviceSize size, VkDeviceSize dstOffset,
+    VkAccessFlags dstAccessMask, VkPipelineStageFlags dstStageMask)
+  {
+    std::lock_guard<std::mutex> lock{this->mutex};
+
+    auto job = std::make_unique<UploadJob>();
+    job->dstBuffer = &dstBuffer;
+    job->data = static_cast<const uint8_t*>(data);
+    job->size = size;
+    job->dstOffset = dstOffset;
+    job->dstAccessMask = dstAccessMask;
+    job->dstStageMask = dstStageMask;
+
+    return this->enqueue(std::move(job));
+  }
+
+  EngineUploadHandle EngineUploadService::uploadImage(EngineImage &dstImage, const void* data, VkDeviceSize size) {
+    std::lock_guard<std::mutex> lock{this->mutex};
+
+    assert(size % dstImage.getHeight() == 0 && "Image data must be tightly packed rows");
+    if (size / dstImage.getHeight() > this->stagingRing->getCapacity()) {
+      throw std::runtime_error("image row does not fit in the staging ring!");
+    }
+
+    auto job = std::make_unique<UploadJob>();
+    job->dstImage = &dstImage;
+    job->data = static_cast<const uint8_t*>(data);
+    job->size = size;
+
+    return this->enqueue(std::move(job));
+  }
+
+  void EngineUploadService::update() {
+    std::lock_guard<std::mutex> lock{this->mutex};
+
+    this->collectCompletedBatches();
+    this->processQueuedJobs();
+    this->submitOpenBatch();
+  }
+
+  void EngineUploadService::flush() {
+    std::lock_guard<std::mutex> lock{this->mutex};
+    this->submitOpenBatch();
+  }
+
+  bool EngineUploadService::isComplete(EngineUploadHandle handle) {
+    std::lock_guard<std::mutex> lock{this->mutex};
+    return this->isCompleteLocked(handle.uploadId);
+  }
+
+  void EngineUploadService::wait(EngineUploadHandle handle) {
+    std::lock_guard<std::mutex> lock{this->mutex};
+
+    while (!this->isCompleteLocked(handle.uploadId)) {
+      this->submitOpenBatch();
+
+      if (!this->submittedBatches.empty()) {
+        vkWaitForFences(this->appDevice.getLogicalDevice(), 1, &this->submittedBatches.front()->fence, VK_TRUE, UINT64_MAX);
+        this->collectCompletedBatches();
+      }
+
+      this->processQueuedJobs();
+    }
+  }
+
+  EngineUploadHandle EngineUploadService::enqueue(std::unique_ptr<UploadJob> job) {
+    job->uploadId = this->nextUploadId++;
+    EngineUploadHandle handle{job->uploadId};
+
+    // earlier uploads still waiting for staging space go first
+    if (this->queuedJobs.empty() && this->recordJob(*job)) {
+      this->recordedUploads[job->uploadId] = this->openBatch->id;
+      return handle;
+    }
+
+    // the ring is full: keep the part that did not make it yet in CPU memory, the
+    // caller's pointer is not valid anymore once we return
+    const uint8_t* remaining = job->data + (job->uploadedSize - job->dataOffset);
+    job->ownedData.assign(remaining, remaining + (job->size - job->uploadedSize));
+    job->data = job->ownedData.data();
+    job->dataOffset = job->uploadedSize;
+
+    this->queuedJobs.emplace_back(std::move(job));
+
+    // get what was already staged moving so its ring space comes back
+    this->submitOpenBatch();
+    return handle;
+  }
+
+  bool EngineUploadService::recordJob(UploadJob &job) {
+    bool isImage = job.dstImage != nullptr;
+    VkDeviceSize rowPitch = isImage ? job.size / job.dstImage->getHeight() : 1;
+
+    while (job.uploadedSize < job.size) {
+      UploadBatch* batch = this->getOpenBatch();
+      VkDeviceSize remainingSize = job.size - job.uploadedSize;
+
+      // images are split on whole rows; buffers in pieces of at least 64 KiB to keep the copy count sane
+      VkDeviceSize minSize = isImage ? rowPitch : std::min<VkDeviceSize>(remainingSize, 64 * 1024);
+      VkDeviceSize stagingOffset, stagingSize;
+
+      if (!this->stagingRing->allocate(minSize, remainingSize, rowPitch, batch->id, stagingOffset, stagingSize)) {
+        return false;
+      }
+
+      memcpy(this->stagingRing->getMappedMemory(stagingOffset), job.data + (job.uploadedSize - job.dataOffset), stagingSize);
+
+      if (isImage) {
+        if (job.uploadedSize == 0) {
+          job.dstImage->transitionImageLayout(batch->transferCommandBuffer, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+        }
+
+        VkBufferImageCopy region{};
+        region.bufferOffset = stagingOffset;
+        region.bufferRowLength = 0;
+        region.bufferImageHeight = 0;
+
+        region.imageSubresource.aspectMask = job.dstImage->getAspectFlags();
+        region.imageSubresource.mipLevel = 0;
+        region.imageSubresource.baseArrayLayer = 0;
+        region.imageSubresource.layerCount = 1;
+
+        region.imageOffset = {0, static_cast<int32_t>(job.uploadedSize / rowPitch), 0};
+        region.imageExtent = {job.dstImage->getWidth(), static_cast<uint32_t>(stagingSize / rowPitch), 1};
+
+        vkCmdCopyBufferToImage(
+          batch->transferCommandBuffer,
+          this->stagingRing->getBuffer(),
+          job.dstImage->getImage(),
+          VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+          1,
+          &region
+        );
+      } else {
+        VkBufferCopy copyRegion{};
+        copyRegion.srcOffset = stagingOffset;
+        copyRegion.dstOffset = job.dstOffset + job.uploadedSize;
+        copyRegion.size = stagingSize;
+        vkCmdCopyBuffer(batch->transferCommandBuffer, this->stagingRing->getBuffer(), job.dstBuffer->getBuffer(), 1, &copyRegion);
+      }
+
+      job.uploadedSize += stagingSize;
+    }
+
+    // the hand-off goes into the batch holding the last copy and covers every earlier one
+    if (isImage) {
+      this->recordImageHandOff(this->getOpenBatch(), job);
+    } else {
+      this->recordBufferHandOff(this->getOpenBatch(), job);
+    }
+
+    return true;
+  }
+
+  void EngineUploadService::recordBufferHandOff(UploadBatch* batch, UploadJob &job) {
+    VkBufferMemoryBarrier barrier{};
+    barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+    barrier.buffer = job.dstBuffer->getBuffer();
+    barrier.offset = job.dstOffset;
+    barrier.size = job.size;
+
+    if (this->hasDedicatedTransferQueue()) {
+      // release on the transfer queue...
+      barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+      barrier.dstAccessMask = 0;
+      barrier.srcQueueFamilyIndex = this->transferFamily;
+      barrier.dstQueueFamilyIndex = this->graphicsFamily;
+
+      vkCmdPipelineBarrier(batch->transferCommandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+        0, 0, nullptr, 1, &barrier, 0, nullptr);
+
+      // ...and acquire the same range on the graphics queue
+      barrier.srcAccessMask = 0;
+      barrier.dstAccessMask = job.dstAccessMask;
+
+      vkCmdPipelineBarrier(batch->graphicsCommandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, job.dstStageMask,
+        0, 0, nullptr, 1, &barrier, 0, nullptr);
+    } else {
+      barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+      barrier.dstAccessMask = job.dstAccessMask;
+      barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+      barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+
+      vkCmdPipelineBarrier(batch->graphicsCommandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, job.dstStageMask,
+        0, 0, nullptr, 1, &barrier, 0, nullptr);
+    }
+  }
+
+  void EngineUploadService::recordImageHandOff(UploadBatch* batch, UploadJob &job) {
+    EngineImage* dstImage = job.dstImage;
+
+    if (this->hasDedicatedTransferQueue()) {
+      VkImageMemoryBarrier barrier{};
+      barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+      barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+      barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+      barrier.srcQueueFamilyIndex = this->transferFamily;
+      barrier.dstQueueFamilyIndex = this->graphicsFamily;
+      barrier.image = dstImage->getImage();
+      barrier.subresourceRange.aspectMask = dstImage->getAspectFlags();
+      barrier.subresourceRange.baseMipLevel = 0;
+      barrier.subresourceRange.levelCount = dstImage->getMipLevels();
+      barrier.subresourceRange.baseArrayLayer = 0;
+      barrier.subresourceRange.layerCount = 1;
+
+      barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+      barrier.dstAccessMask = 0;
+
+      vkCmdPipelineBarrier(batch->transferCommandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+        0, 0, nullptr, 0, nullptr, 1, &barrier);
+
+      barrier.srcAccessMask = 0;
+      barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT | VK_ACCESS_TRANSFER_WRITE_BIT;
+
+      vkCmdPipelineBarrier(batch->graphicsCommandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
+        0, 0, nullptr, 0, nullptr, 1, &barrier);
+    }
+
+    // blits need a graphics capable queue, so the mip chain is always built after the hand-off
+    if (dstImage->getMipLevels() > 1) {
+      dstImage->generateMipMap(batch->graphicsCommandBuffer);
+    } else {
+      dstImage->transitionImageLayout(batch->graphicsCommandBuffer, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+    }
+  }
+
+  void EngineUploadService::processQueuedJobs() {
+    while (!this->queuedJobs.empty()) {
+      auto &job = *this->queuedJobs.front();
+
+      if (!this->recordJob(job)) {
+        this->submitOpenBatch();
+        return;
+      }
+
+      this->recordedUploads[job.uploadId] = this->openBatch->id;
+      this->queuedJobs.pop_front();
+    }
+  }
+
+  bool EngineUploadService::isCompleteLocked(uint64_t uploadId) {
+    if (uploadId == 0) return true;
+
+    this->collectCompletedBatches();
+
+    for (auto &&job : this->queuedJobs) {
+      if (job->uploadId == uploadId) return false;
+    }
+
+    // entries are dropped once their batch has finished
+    return this->recordedUploads.find(uploadId) == this->recordedUploads.end();
+  }
+
+  VkCommandPool EngineUploadService::createCommandPool(uint32_t queueFamily) {
+    VkCommandPoolCreateInfo poolInfo = {};
+    poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+    poolInfo.queueFamilyIndex = queueFamily;
+    poolInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+
+    VkCommandPool commandPool;
+    if (vkCreateCommandPool(this->appDevice.getLogicalDevice(), &poolInfo, nullptr, &commandPool) != VK_SUCCESS) {
+      throw std::runtime_error("failed to create upload command pool!");
+    }
+
+    return commandPool;
+  }
+
+  VkCommandBuffer EngineUploadService::beginCommandBuffer(VkCommandPool commandPool) {
+    VkCommandBufferAllocateInfo allocInfo{};
+    allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+    allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+    allocInfo.commandPool = commandPool;
+    allocInfo.commandBufferCount = 1;
+
+    VkCommandBuffer commandBuffer;
+    if (vkAllocateCommandBuffers(this->appDevice.getLogicalDevice(), &allocInfo, &commandBuffer) != VK_SUCCESS) {
+      throw std::runtime_error("failed to allocate upload command buffer");
+    }
+
+    VkCommandBufferBeginInfo beginInfo{};
+    beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+
+    if (vkBeginCommandBuffer(commandBuffer, &beginInfo) != VK_SUCCESS) {
+      throw std::runtime_error("failed to begin upload command buffer");
+    }
+
+    return commandBuffer;
+  }
+
+  EngineUploadService::UploadBatch* EngineUploadService::getOpenBatch() {
+    if (this->openBatch != nullptr) {
+      return this->openBatch.get();
+    }
+
+    auto batch = std::make_unique<UploadBatch>();
+    batch->id = this->nextBatchId++;
+    batch->graphicsCommandBuffer = this->beginCommandBuffer(this->graphicsCommandPool);
+
+    if (this->hasDedicatedTransferQueue()) {
+      batch->transferCommandBuffer = this->beginCommandBuffer(this->transferCommandPool);
+
+      VkSemaphoreCreateInfo semaphoreInfo = {};
+      semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+
+      if (vkCreateSemaphore(this->appDevice.getLogicalDevice(), &semaphoreInfo, nullptr, &batch->transferSemaphore) != VK_SUCCESS) {
+        throw std::runtime_error("failed to create upload semaphore!");
+      }
+    } else {
+      // no separate copy engine: copies and hand-off work share one graphics command buffer
+      batch->transferCommandBuffer = batch->graphicsCommandBuffer;
+    }
+
+    VkFenceCreateInfo fenceInfo = {};
+    fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+
+    if (vkCreateFence(this->appDevice.getLogicalDevice(), &fenceInfo, nullptr, &batch->fence) != VK_SUCCESS) {
+      throw std::runtime_error("failed to create upload fence!");
+    }
+
+    this->openBatch = std::move(batch);
+    return this->openBatch.get();
+  }
+
+  void EngineUploadService::submitOpenBatch() {
+    if (this->openBatch == nullptr) {
+      return;
+    }
+
+    auto batch = std::move(this->openBatch);
+
+    if (this->hasDedicatedTransferQueue()) {
+      if (vkEndCommandBuffer(batch->transferCommandBuffer) != VK_SUCCESS) {
+        throw std::runtime_error("failed to end upload command buffer");
+      }
+
+      VkSubmitInfo transferSubmit{};
+      transferSubmit.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+      transferSubmit.commandBufferCount = 1;
+      transferSubmit.pCommandBuffers = &batch->transferCommandBuffer;
+      transferSubmit.signalSemaphoreCount = 1;
+      transferSubmit.pSignalSemaphores = &batch->transferSemaphore;
+
+      if (vkQueueSubmit(this->appDevice.getTransferQueue(), 1, &transferSubmit, VK_NULL_HANDLE) != VK_SUCCESS) {
+        throw std::runtime_error("failed to submit upload to transfer queue");
+      }
+    }
+
+    if (vkEndCommandBuffer(batch->graphicsCommandBuffer) != VK_SUCCESS) {
+      throw std::runtime_error("failed to end upload command buffer");
+    }
+
+    VkPipelineStageFlags waitStage = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+
+    VkSubmitInfo graphicsSubmit{};
+    graphicsSubmit.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+    graphicsSubmit.commandBufferCount = 1;
+    graphicsSubmit.pCommandBuffers = &batch->graphicsCommandBuffer;
+
+    if (this->hasDedicatedTransferQueue()) {
+      graphicsSubmit.waitSemaphoreCount = 1;
+      graphicsSubmit.pWaitSemaphores = &batch->transferSemaphore;
+      graphicsSubmit.pWaitDstStageMask = &waitStage;
+    }
+
+    if (vkQueueSubmit(this->appDevice.getGraphicsQueue(), 1, &graphicsSubmit, batch->fence) != VK_SUCCESS) {
+      throw std::runtime_error("failed to submit upload to graphics queue");
+    }
+
+    this->submittedBatches.emplace_back(std::move(batch));
+  }
+
+  void EngineUploadService::collectCompletedBatches() {
+    while (!this->submittedBatches.empty()) {
+      auto &batch = this->submittedBatches.front();
+      if (vkGetFenceStatus(this->appDevice.getLogicalDevice(), batch->fence) != VK_SUCCESS) {
+        break;
+      }
+
+      this->lastCompletedId = batch->id;
+
+      auto completedBatch = std::move(batch);
+      this->submittedBatches.pop_front();
+      this->destroyBatch(std::move(completedBatch));
+    }
+
+    this->stagingRing->release(this->lastCompletedId);
+
+    while (!this->recordedUploads.empty() && this->recordedUploads.begin()->second <= this->lastCompletedId) {
+      this->recordedUploads.erase(this->recordedUploads.begin());
+    }
+  }
+
+  void EngineUploadService::destroyBatch(std::unique_ptr<UploadBatch> batch) {
+    if (this->hasDedicatedTransferQueue()) {
+      vkFreeCommandBuffers(this->appDevice.getLogicalDevice(), this->transferCommandPool, 1, &batch->transferCommandBuffer);
+      vkDestroySemaphore(this->appDevice.getLogicalDevice(), batch->transferSemaphore, nullptr);
+    }
+
+    vkFreeCommandBuffers(this->appDevice.getLogicalDevice(), this->graphicsCommandPool, 1, &batch->graphicsCommandBuffer);
+    vkDestroyFence(this->appDevice.getLogicalDevice(), batch->fence, nullptr);
+  }
+
+} // namespace nugiEngine
@@ -0,0 +1,109 @@
+#pragma once
+
+#include "../device/device.hpp"
+#include "../buffer/buffer.hpp"
+#include "../image/image.hpp"
+#include "staging_ring.hpp"
+
+// std lib headers
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace nugiEngine {
+  // Identifies one upload request. A default handle is always complete
+  struct EngineUploadHandle {
+    uint64_t uploadId = 0;
+  };
+
+  class EngineUploadService {
+    public:
+      EngineUploadService(EngineDevice &device);
+      ~EngineUploadService();
+
+      EngineUploadService(const EngineUploadService &) = delete;
+      EngineUploadService &operator=(const EngineUploadService &) = delete;
+
+      // data is copied into the staging ring (or a CPU side copy if the ring is full) before returning
+      EngineUploadHandle uploadBuffer(EngineBuffer &dstBuffer, const void* data, VkDeviceSize size, VkDeviceSize dstOffset = 0,
+        VkAccessFlags dstAccessMask = VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT | VK_ACCESS_INDEX_READ_BIT,
+        VkPipelineStageFlags dstStageMask = VK_PIPELINE_STAGE_VERTEX_INPUT_BIT);
+
+      // leaves the image in SHADER_READ_ONLY_OPTIMAL, generating the mip chain on the graphics queue
+      EngineUploadHandle uploadImage(EngineImage &dstImage, const void* data, VkDeviceSize size);
+
+      // call once per frame: recycles finished staging space and streams the rest of queued uploads
+      void update();
+
+      void flush();
+      bool isComplete(EngineUploadHandle handle);
+      void wait(EngineUploadHandle handle);
+
+      bool hasDedicatedTransferQueue() const { return this->transferFamily != this->graphicsFamily; }
+
+    private:
+      struct UploadBatch {
+        uint64_t id = 0;
+        VkCommandBuffer transferCommandBuffer = VK_NULL_HANDLE;
+        VkCommandBuffer graphicsCommandBuffer = VK_NULL_HANDLE;
+        VkSemaphore transferSemaphore = VK_NULL_HANDLE;
+        VkFence fence = VK_NULL_HANDLE;
+      };
+
+      // The destination must stay alive until the upload is complete
+      struct UploadJob {
+        uint64_t uploadId = 0;
+        EngineBuffer* dstBuffer = nullptr;
+        EngineImage* dstImage = nullptr;
+
+        // source byte i lives at data[i - dataOffset]; dataOffset > 0 once the tail was copied to ownedData
+        const uint8_t* data = nullptr;
+        VkDeviceSize dataOffset = 0;
+        std::vector<uint8_t> ownedData;
+
+        VkDeviceSize size = 0;
+        VkDeviceSize uploadedSize = 0;
+        VkDeviceSize dstOffset = 0;
+        VkAccessFlags dstAccessMask = 0;
+        VkPipelineStageFlags dstStageMask = 0;
+      };
+
+      EngineDevice &appDevice;
+      std::unique_ptr<EngineStagingRing> stagingRing;
+
+      uint32_t transferFamily;
+      uint32_t graphicsFamily;
+      VkCommandPool transferCommandPool = VK_NULL_HANDLE;
+      VkCommandPool graphicsCommandPool = VK_NULL_HANDLE;
+
+      std::unique_ptr<UploadBatch> openBatch;
+      std::deque<std::unique_ptr<UploadBatch>> submittedBatches;
+      uint64_t nextBatchId = 1;
+      uint64_t lastCompletedId = 0;
+
+      std::deque<std::unique_ptr<UploadJob>> queuedJobs;
+      std::map<uint64_t, uint64_t> recordedUploads; // upload id -> batch holding its last copy
+      uint64_t nextUploadId = 1;
+
+      std::mutex mutex;
+
+      VkCommandPool createCommandPool(uint32_t queueFamily);
+      VkCommandBuffer beginCommandBuffer(VkCommandPool commandPool);
+
+      EngineUploadHandle enqueue(std::unique_ptr<UploadJob> job);
+      bool recordJob(UploadJob &job);
+      void recordBufferHandOff(UploadBatch* batch, UploadJob &job);
+      void recordImageHandOff(UploadBatch* batch, UploadJob &job);
+      void processQueuedJobs();
+      bool isCompleteLocked(uint64_t uploadId);
+
+      UploadBatch* getOpenBatch();
+      void submitOpenBatch();
+      void collectCompletedBatches();
+      void destroyBatch(std::unique_ptr<UploadBatch> batch);
+  };
+
+} // namespace nugiEngine
@@ -0,0 +1,62 @@
+#include "mapped_file.hpp"
+
+#if defined(__unix__) || defined(__APPLE__)
+  #define NUGI_HAS_MMAP
+  #include <fcntl.h>
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+  #include <unistd.h>
+#else
+  #include <fstream>
+#endif
+
+namespace nugiEngine {
+  EngineMappedFile::~EngineMappedFile() {
+#ifdef NUGI_HAS_MMAP
+    if (this->isMapped) {
+      munmap(const_cast<uint8_t*>(this->data), this->size);
+    }
+#endif
+  }
+
+  std::unique_ptr<EngineMappedFile> EngineMappedFile::open(const std::string &filePath) {
+    std::unique_ptr<EngineMappedFile> file{new EngineMappedFile()};
+
+#ifdef NUGI_HAS_MMAP
+    int fileDescriptor = ::open(filePath.c_str(), O_RDONLY);
+    if (fileDescriptor < 0) return nullptr;
+
+    struct stat fileStat{};
+    if (fstat(fileDescriptor, &fileStat) != 0 || fileStat.st_size <= 0) {
+      close(fileDescriptor);
+      return nullptr;
+    }
+
+    void* mapped = mmap(nullptr, static_cast<size_t>(fileStat.st_size), PROT_READ, MAP_PRIVATE, fileDescriptor, 0);
+
+    // the mapping keeps its own reference to the file
+    close(fileDescriptor);
+    if (mapped == MAP_FAILED) return nullptr;
+
+    file->data = static_cast<const uint8_t*>(mapped);
+    file->size = static_cast<size_t>(fileStat.st_size);
+    file->isMapped = true;
+#else
+    std::ifstream stream{filePath, std::ios::binary | std::ios::ate};
+    if (!stream.is_open()) return nullptr;
+
+    file->fallbackData.resize(static_cast<size_t>(stream.tellg()));
+    stream.seekg(0);
+
+    if (file->fallbackData.empty() || !stream.read(reinterpret_cast<char*>(file->fallbackData.data()), file->fallbackData.size())) {
+      return nullptr;
+    }
+
+    file->data = file->fallbackData.data();
+    file->size = file->fallbackData.size();
+#endif
+
+    return file;
+  }
+  
+} // namespace nugiEngine
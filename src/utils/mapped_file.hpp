@@ -0,0 +1,36 @@
+#pragma once
+
+// std lib headers
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace nugiEngine {
+  // Read-only view of a whole file. Memory mapped where the platform has mmap, so pages are only
+  // read from disk once they are touched; elsewhere the file is read into memory
+  class EngineMappedFile {
+    public:
+      ~EngineMappedFile();
+
+      EngineMappedFile(const EngineMappedFile &) = delete;
+      EngineMappedFile &operator=(const EngineMappedFile &) = delete;
+
+      // null when the file does not exist or cannot be mapped
+      static std::unique_ptr<EngineMappedFile> open(const std::string &filePath);
+
+      const uint8_t* getData() const { return this->data; }
+      size_t getSize() const { return this->size; }
+
+    private:
+      EngineMappedFile() = default;
+
+      const uint8_t* data = nullptr;
+      size_t size = 0;
+
+      bool isMapped = false;
+      std::vector<uint8_t> fallbackData;
+  };
+  
+} // namespace nugiEngine